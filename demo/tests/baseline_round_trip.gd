@@ -0,0 +1,158 @@
+extends SceneTree
+
+# Check for SceneSynchronizerServer's baseline delta compression: snapshots are deltas against the newest one the peer
+# acknowledged, lost snapshots are never used as a base, and a receiver missing its baseline reports the net ID so the
+# sender can reset it. Run from the repository root with:
+#   godot --headless --path demo --script res://tests/baseline_round_trip.gd
+# Exits with the number of failed checks.
+
+const ReplicatedStateNode = preload("res://tests/replicated_state_node.gd")
+
+const PROPERTIES = [^":count", ^":label", ^":offset"]
+const NET_ID = 7
+const PEER_ID = 2
+
+var failures := 0
+var server: SceneSynchronizerServer
+var multiplayer_synchronizer := MultiplayerSynchronizer.new()
+var sender: ReplicatedStateNode
+var receiver: ReplicatedStateNode
+var sender_sync: SceneSynchronizer
+var receiver_sync: SceneSynchronizer
+var failed := []
+
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL: ", message)
+
+
+func varint(value: int) -> PackedByteArray:
+	var bytes := PackedByteArray()
+	while value >= 0x80:
+		bytes.append((value & 0x7F) | 0x80)
+		value >>= 7
+	bytes.append(value)
+	return bytes
+
+
+func add_synchronized_node(interval: float) -> ReplicatedStateNode:
+	var node := ReplicatedStateNode.new()
+	var synchronizer := SceneSynchronizer.new()
+	synchronizer.name = "SceneSynchronizer"
+	synchronizer.multiplayer_synchronizer = multiplayer_synchronizer
+	synchronizer.root_path = ^".."
+	synchronizer.replication_interval = interval
+	node.add_child(synchronizer)
+	root.add_child(node)
+	return node
+
+
+# Sender and receiver share the server, so the net ID moves to the receiver while a packet is applied.
+func deliver(packet: PackedByteArray) -> int:
+	sender_sync.set_net_id(0)
+	receiver_sync.set_net_id(NET_ID)
+	failed.clear()
+	var snapshot_id := server.apply_baseline_states(packet, failed)
+	receiver_sync.set_net_id(0)
+	sender_sync.set_net_id(NET_ID)
+	return snapshot_id
+
+
+func same_state() -> bool:
+	return receiver.count == sender.count and receiver.label == sender.label and receiver.offset == sender.offset
+
+
+func gather(usec: int) -> PackedByteArray:
+	return server.gather_baseline_states(usec).get(PEER_ID, PackedByteArray())
+
+
+func verify_acknowledged_deltas() -> void:
+	sender.count = 1
+	sender.label = "first"
+	sender.offset = Vector3(1, 2, 3)
+	var full := gather(1000)
+	check(not full.is_empty(), "first snapshot is sent")
+	var snapshot_id := deliver(full)
+	check(snapshot_id > 0 and failed.is_empty(), "first snapshot applies")
+	check(same_state(), "first snapshot carries the full state")
+	server.acknowledge_snapshot(PEER_ID, snapshot_id)
+
+	sender.count = 2
+	var delta := gather(2000)
+	check(not delta.is_empty() and delta.size() < full.size(), "snapshot after an acknowledgement is a delta")
+	snapshot_id = deliver(delta)
+	check(snapshot_id > 0 and failed.is_empty() and same_state(), "delta snapshot applies")
+	server.acknowledge_snapshot(PEER_ID, snapshot_id)
+
+	check(gather(3000).is_empty(), "nothing is sent without changes")
+
+	# The first of these is lost, so the second still has to carry its change.
+	sender.label = "lost"
+	gather(4000)
+	sender.count = 3
+	snapshot_id = deliver(gather(5000))
+	check(snapshot_id > 0 and failed.is_empty() and same_state(), "unacknowledged snapshot is not used as a base")
+	server.acknowledge_snapshot(PEER_ID, snapshot_id)
+
+
+func verify_reset() -> void:
+	# Leaving the tree drops the receiver's baselines, like a local respawn.
+	root.remove_child(receiver)
+	root.add_child(receiver)
+
+	sender.count = 4
+	check(deliver(gather(6000)) > 0 and failed == [NET_ID], "delta against a missing baseline is reported")
+	check(receiver.count != 4, "failed entry is not applied")
+
+	server.reset_peer_baseline(PEER_ID, NET_ID)
+	check(deliver(gather(7000)) > 0 and failed.is_empty(), "snapshot after a reset applies")
+	check(same_state(), "snapshot after a reset carries the full state")
+
+
+func verify_malformed_packets() -> void:
+	check(server.apply_baseline_states(PackedByteArray()) == -1, "empty packet fails")
+	check(server.apply_baseline_states(varint(0)) == -1, "snapshot id 0 fails")
+	check(server.apply_baseline_states(varint(1 << 32)) == -1, "snapshot id beyond 32 bits fails")
+	check(server.apply_baseline_states(varint(1) + varint(1 << 32) + varint(0)) == -1, "net ID beyond 32 bits fails")
+	check(server.apply_baseline_states(varint(1) + varint(NET_ID) + varint(100)) == -1, "entry larger than the packet fails")
+
+	var unknown := varint(1) + varint(12345) + varint(2) + PackedByteArray([0, 0])
+	check(deliver(unknown) == 1 and failed.is_empty(), "entries of unknown net IDs are skipped")
+
+	# Entries are a baseline id and a one byte mask over the properties.
+	var wide_base := varint(1 << 32) + PackedByteArray([0])
+	check(deliver(varint(9) + varint(NET_ID) + varint(wide_base.size()) + wide_base) == 9 and failed == [NET_ID], "baseline id beyond 32 bits is reported")
+	var missing_base := varint(999) + PackedByteArray([0])
+	check(deliver(varint(9) + varint(NET_ID) + varint(missing_base.size()) + missing_base) == 9 and failed == [NET_ID], "missing baseline is reported")
+
+
+func _initialize() -> void:
+	server = Engine.get_singleton("SceneSynchronizerServer")
+	server.phase_staggering = false
+	var config := SceneReplicationConfig.new()
+	for path in PROPERTIES:
+		config.add_property(path)
+	multiplayer_synchronizer.replication_config = config
+
+	sender = add_synchronized_node(0.0)
+	# The receiver is never due, so it writes no snapshots of its own.
+	receiver = add_synchronized_node(3600.0)
+	sender_sync = sender.get_node("SceneSynchronizer")
+	receiver_sync = receiver.get_node("SceneSynchronizer")
+	sender_sync.set_net_id(NET_ID)
+	server.add_baseline_peer(PEER_ID)
+
+	verify_acknowledged_deltas()
+	verify_reset()
+	verify_malformed_packets()
+
+	server.remove_baseline_peer(PEER_ID)
+	sender.free()
+	receiver.free()
+	multiplayer_synchronizer.free()
+
+	if failures == 0:
+		print("Baseline round trip: OK")
+	quit(failures)
@@ -0,0 +1,10 @@
+extends Node2D
+
+# Keeps the dictionary _deserialize() received so node_serializer_round_trip.gd can inspect it.
+static var last_received: Dictionary
+
+var payload: Array = []
+
+
+func _deserialize(data: Dictionary) -> void:
+	last_received = data
@@ -0,0 +1,148 @@
+extends SceneTree
+
+# Check for the net ID table behind SceneSynchronizerServer.get_synchronizer_by_net_id(): removals shift the rest of a
+# probe run back, including runs that wrap around the end of the table, so every remaining net ID stays reachable. Run
+# from the repository root with:
+#   godot --headless --path demo --script res://tests/net_id_registry.gd
+# Exits with the number of failed checks.
+
+# The table keeps its initial 64 slots until more than 32 net IDs are registered, which none of these checks reach.
+const SLOT_SHIFT = 26
+
+var failures := 0
+var server: SceneSynchronizerServer
+var holder := Node.new()
+# Net ID -> the SceneSynchronizer registered under it.
+var synchronizers := {}
+
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL: ", message)
+
+
+func home_slot(net_id: int) -> int:
+	return ((net_id * 2654435769) & 0xFFFFFFFF) >> SLOT_SHIFT
+
+
+func ids_with_home(slot: int, count: int) -> Array:
+	var ids := []
+	var net_id := 1
+	while ids.size() < count:
+		if home_slot(net_id) == slot:
+			ids.append(net_id)
+		net_id += 1
+	return ids
+
+
+func add(net_id: int) -> SceneSynchronizer:
+	var synchronizer := SceneSynchronizer.new()
+	synchronizer.root_path = ^".."
+	holder.add_child(synchronizer)
+	# Entering the tree resets the net ID, so it is assigned once registered.
+	synchronizer.set_net_id(net_id)
+	synchronizers[net_id] = synchronizer
+	return synchronizer
+
+
+func remove(net_id: int) -> void:
+	synchronizers[net_id].free()
+	synchronizers.erase(net_id)
+
+
+func verify_lookups(removed: Array, label: String) -> void:
+	var found := 0
+	for net_id in synchronizers:
+		if server.get_synchronizer_by_net_id(net_id) == synchronizers[net_id]:
+			found += 1
+	check(found == synchronizers.size(), label + ": every remaining net ID is found")
+	for net_id in removed:
+		check(server.get_synchronizer_by_net_id(net_id) == null, label + ": removed net ID %d is gone" % net_id)
+
+
+func remove_all() -> void:
+	for net_id in synchronizers.keys():
+		remove(net_id)
+
+
+# A run starting in the last slot wraps to the front, where later entries of other home slots continue it.
+func verify_wrapping_run() -> void:
+	var last := ids_with_home(63, 4)
+	var first := ids_with_home(0, 2)
+	var second := ids_with_home(1, 1)
+	for net_id in last + first + second:
+		add(net_id)
+	verify_lookups([], "wrapping run")
+
+	var removed := []
+	for net_id in [last[0], first[0], last[3], second[0], last[1], first[1], last[2]]:
+		remove(net_id)
+		removed.append(net_id)
+		verify_lookups(removed, "wrapping run without %d" % net_id)
+
+
+# Entries already in their home slot stay put while later ones in the run move past them.
+func verify_partial_shift() -> void:
+	var home_10 := ids_with_home(10, 2)
+	var home_11 := ids_with_home(11, 1)
+	var home_12 := ids_with_home(12, 1)
+	for net_id in [home_10[0], home_10[1], home_12[0], home_11[0]]:
+		add(net_id)
+	remove(home_10[0])
+	verify_lookups([home_10[0]], "partial shift")
+	remove(home_10[1])
+	verify_lookups([home_10[0], home_10[1]], "partial shift")
+	remove_all()
+
+
+func verify_churn() -> void:
+	var rng := RandomNumberGenerator.new()
+	rng.seed = 16
+	var removed := []
+	for i in 400:
+		if synchronizers.size() < 30 and (synchronizers.is_empty() or rng.randi_range(0, 2) > 0):
+			var net_id := rng.randi_range(1, 2000)
+			if not synchronizers.has(net_id):
+				add(net_id)
+				removed.erase(net_id)
+		else:
+			var net_id: int = synchronizers.keys()[rng.randi_range(0, synchronizers.size() - 1)]
+			remove(net_id)
+			removed.append(net_id)
+	verify_lookups(removed, "churn")
+	remove_all()
+	verify_lookups(removed, "churn cleared")
+
+
+func verify_reassigned_net_id() -> void:
+	check(server.get_synchronizer_by_net_id(0) == null, "net ID 0 is never registered")
+	var wide := add(0xFFFFFFFF)
+	check(server.get_synchronizer_by_net_id(0xFFFFFFFF) == wide, "largest net ID is found")
+	remove(0xFFFFFFFF)
+
+	# A net ID taken over by another synchronizer stays registered when the previous owner leaves.
+	var previous := add(42)
+	var current := add(43)
+	current.set_net_id(42)
+	previous.free()
+	check(server.get_synchronizer_by_net_id(42) == current, "net ID stays with its new owner")
+	current.free()
+	synchronizers.clear()
+	check(server.get_synchronizer_by_net_id(42) == null, "net ID is gone with its last owner")
+
+
+func _initialize() -> void:
+	server = Engine.get_singleton("SceneSynchronizerServer")
+	root.add_child(holder)
+
+	verify_wrapping_run()
+	verify_partial_shift()
+	verify_churn()
+	verify_reassigned_net_id()
+
+	holder.free()
+
+	if failures == 0:
+		print("Net ID registry: OK")
+	quit(failures)
@@ -0,0 +1,136 @@
+extends SceneTree
+
+# Round-trip check for NodeSerializer's binary formats. Run from the repository root with:
+#   godot --headless --path demo --script res://tests/node_serializer_round_trip.gd
+# Exits with the number of failed checks.
+
+const CustomDeserializeNode = preload("res://tests/custom_deserialize_node.gd")
+
+var failures := 0
+
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL: ", message)
+
+
+func build_value() -> Array:
+	var root := Node2D.new()
+	root.position = Vector2(1, 2)
+
+	var child := Node2D.new()
+	child.name = "Child"
+	child.position = Vector2(3, 4)
+	child.rotation = 0.5
+	root.add_child(child)
+
+	var grandchild := Node2D.new()
+	grandchild.name = "Grandchild"
+	grandchild.position = Vector2(5, 6)
+	child.add_child(grandchild)
+
+	return [null, 5, [null, [1, "two", null]], {"a": null, "b": {"c": [null, 7]}}, root, Vector3(1, 2, 3), null]
+
+
+func verify(result: Variant, label: String) -> void:
+	check(result is Array, label + ": result is an Array")
+	if not result is Array:
+		return
+	check(result.size() == 7, label + ": array size")
+	if result.size() != 7:
+		return
+
+	check(result[0] == null, label + ": leading null")
+	check(result[1] == 5, label + ": int after null")
+	check(result[2] == [null, [1, "two", null]], label + ": nested arrays with nulls")
+	check(result[3] == {"a": null, "b": {"c": [null, 7]}}, label + ": nested dictionaries with nulls")
+	check(result[5] == Vector3(1, 2, 3), label + ": value after object")
+	check(result[6] == null, label + ": trailing null")
+
+	var root := result[4] as Node2D
+	check(root != null, label + ": object deserialized")
+	if root == null:
+		return
+	check(root.position == Vector2(1, 2), label + ": object property")
+
+	var child := root.get_node_or_null("Child") as Node2D
+	check(child != null, label + ": child node")
+	if child:
+		check(child.position == Vector2(3, 4), label + ": child position")
+		check(is_equal_approx(child.rotation, 0.5), label + ": child rotation")
+		var grandchild := child.get_node_or_null("Grandchild") as Node2D
+		check(grandchild != null and grandchild.position == Vector2(5, 6), label + ": grandchild")
+	root.free()
+
+
+# Objects with _deserialize() receive the serialized structure: nested objects and children stay dictionaries.
+func verify_custom_deserializer(data: PackedByteArray, label: String) -> void:
+	CustomDeserializeNode.last_received = {}
+	var result = NodeSerializer.deserialize_from_binary(data)
+	var received := CustomDeserializeNode.last_received
+	check(received.get("._type") == CustomDeserializeNode.resource_path, label + ": custom type field")
+
+	var payload = received.get("payload")
+	check(payload is Array and payload.size() == 1 and payload[0] is Dictionary, label + ": nested object kept serialized")
+	if payload is Array and payload.size() == 1 and payload[0] is Dictionary:
+		check(payload[0].get("._type") == "Node2D", label + ": nested object type")
+
+	var children = received.get("._children")
+	check(children is Dictionary and children.get("Child") is Dictionary, label + ": children kept serialized")
+	if children is Dictionary and children.get("Child") is Dictionary:
+		check(children["Child"].get("position") == Vector2(3, 4), label + ": child structure")
+	if result is Node:
+		check(result.get_child_count() == 0, label + ": children left to _deserialize()")
+		result.free()
+
+
+func free_value(value: Variant) -> void:
+	if value is Array:
+		for element in value:
+			free_value(element)
+	elif value is Dictionary:
+		for key in value:
+			free_value(value[key])
+	elif value is Object and is_instance_valid(value) and not value is RefCounted:
+		if not (value is Node and value.get_parent()):
+			value.free()
+
+
+# Corrupting any byte of the value must either fail cleanly or decode something, never leak the nodes read so far.
+func verify_corrupt_payloads(data: PackedByteArray) -> void:
+	var schema_offset := data.decode_u32(4)
+	var nodes_before := Performance.get_monitor(Performance.OBJECT_NODE_COUNT)
+	for i in range(8, schema_offset):
+		var corrupt := data.duplicate()
+		corrupt[i] = 0xFF
+		free_value(NodeSerializer.deserialize_from_binary(corrupt))
+	check(Performance.get_monitor(Performance.OBJECT_NODE_COUNT) == nodes_before, "corrupt payloads: no nodes leaked")
+
+
+func _init() -> void:
+	NodeSerializer.register_serializable_class("Node2D")
+	NodeSerializer.register_serializable_class(CustomDeserializeNode.resource_path)
+
+	var value := build_value()
+	verify(NodeSerializer.deserialize_from_binary(NodeSerializer.serialize_to_binary(value)), "binary")
+	verify(NodeSerializer.deserialize_from_binary(var_to_bytes(NodeSerializer.serialize_to_binary_structure(value))), "legacy")
+	verify_corrupt_payloads(NodeSerializer.serialize_to_binary(value))
+	value[4].free()
+
+	var custom = CustomDeserializeNode.new()
+	var nested := Node2D.new()
+	nested.position = Vector2(7, 8)
+	custom.payload = [nested]
+	var custom_child := Node2D.new()
+	custom_child.name = "Child"
+	custom_child.position = Vector2(3, 4)
+	custom.add_child(custom_child)
+	verify_custom_deserializer(NodeSerializer.serialize_to_binary(custom), "custom binary")
+	verify_custom_deserializer(var_to_bytes(NodeSerializer.serialize_to_binary_structure(custom)), "custom legacy")
+	custom.free()
+	nested.free()
+
+	if failures == 0:
+		print("NodeSerializer round trip: OK")
+	quit(failures)
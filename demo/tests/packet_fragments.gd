@@ -0,0 +1,136 @@
+extends SceneTree
+
+# Check for SceneSynchronizerServer's packet aggregation: states larger than the MTU are split into fragments that
+# reassemble in any order, at most MAX_ASSEMBLIES incomplete groups are kept per peer, and malformed fragments are
+# dropped. Run from the repository root with:
+#   godot --headless --path demo --script res://tests/packet_fragments.gd
+# Exits with the number of failed checks.
+
+const ReplicatedStateNode = preload("res://tests/replicated_state_node.gd")
+
+const NET_ID = 7
+const MTU = 64
+const MAX_ASSEMBLIES = 8
+
+var failures := 0
+var server: SceneSynchronizerServer
+var multiplayer_synchronizer := MultiplayerSynchronizer.new()
+
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL: ", message)
+
+
+func add_synchronized_node(interval: float) -> ReplicatedStateNode:
+	var node := ReplicatedStateNode.new()
+	var synchronizer := SceneSynchronizer.new()
+	synchronizer.name = "SceneSynchronizer"
+	synchronizer.multiplayer_synchronizer = multiplayer_synchronizer
+	synchronizer.root_path = ^".."
+	synchronizer.replication_interval = interval
+	node.add_child(synchronizer)
+	root.add_child(node)
+	return node
+
+
+# A fragment packet: type 1, u16 group, u8 index, u8 count, then the slice.
+func fragment(group: int, index: int, count: int, data: Array) -> PackedByteArray:
+	var packet := PackedByteArray([1, 0, 0, index, count])
+	packet.encode_u16(1, group)
+	return packet + PackedByteArray(data)
+
+
+func verify_gathered_fragments() -> void:
+	var config := SceneReplicationConfig.new()
+	config.add_property(^":count")
+	config.add_property(^":label")
+	multiplayer_synchronizer.replication_config = config
+
+	var sender := add_synchronized_node(0.0)
+	# The receiver is never due, so only the sender's state is gathered.
+	var receiver := add_synchronized_node(3600.0)
+	var sender_sync: SceneSynchronizer = sender.get_node("SceneSynchronizer")
+	var receiver_sync: SceneSynchronizer = receiver.get_node("SceneSynchronizer")
+	sender_sync.set_net_id(NET_ID)
+	sender.count = 5
+	sender.label = "fragment ".repeat(40)
+
+	server.packet_mtu = MTU
+	var packets: Array = server.gather_sync_packets(1000).get(0, [])
+	check(packets.size() > 1, "state larger than the MTU is fragmented")
+	for packet in packets:
+		check(packet.size() <= MTU and packet[0] == 1, "fragments fit the MTU")
+
+	# Delivered last to first: only the final fragment completes the batch.
+	var batch := PackedByteArray()
+	for i in range(packets.size() - 1, -1, -1):
+		batch = server.receive_packet(1, packets[i])
+		check(batch.is_empty() == (i > 0), "fragment %d completes the batch only when it is the last one missing" % i)
+
+	sender_sync.set_net_id(0)
+	receiver_sync.set_net_id(NET_ID)
+	check(server.apply_batch(batch) == 1, "reassembled batch applies")
+	check(receiver.count == 5 and receiver.label == sender.label, "reassembled state round trip")
+
+	sender.free()
+	receiver.free()
+
+
+func verify_assemblies() -> void:
+	const PEER_ID = 2
+	# Starting one group more than are kept drops the oldest.
+	for group in MAX_ASSEMBLIES + 1:
+		check(server.receive_packet(PEER_ID, fragment(group, 0, 2, [group])).is_empty(), "group %d is incomplete" % group)
+	for group in range(MAX_ASSEMBLIES, 0, -1):
+		check(server.receive_packet(PEER_ID, fragment(group, 1, 2, [group + 100])) == PackedByteArray([group, group + 100]), "group %d reassembles" % group)
+	check(server.receive_packet(PEER_ID, fragment(0, 1, 2, [100])).is_empty(), "dropped group does not complete")
+	check(server.receive_packet(PEER_ID, fragment(0, 0, 2, [0])) == PackedByteArray([0, 100]), "dropped group reassembles when resent")
+
+	# Peers reassemble separately.
+	check(server.receive_packet(PEER_ID, fragment(20, 0, 2, [1])).is_empty(), "first half for one peer")
+	check(server.receive_packet(PEER_ID + 1, fragment(20, 1, 2, [2])).is_empty(), "second half for another peer")
+	check(server.receive_packet(PEER_ID, fragment(20, 1, 2, [2])) == PackedByteArray([1, 2]), "halves of the same peer reassemble")
+
+	# Duplicates are only counted once.
+	check(server.receive_packet(PEER_ID, fragment(21, 0, 3, [1])).is_empty(), "first of three")
+	check(server.receive_packet(PEER_ID, fragment(21, 0, 3, [1])).is_empty(), "duplicate fragment")
+	check(server.receive_packet(PEER_ID, fragment(21, 1, 3, [2])).is_empty(), "duplicate does not complete the group")
+	check(server.receive_packet(PEER_ID, fragment(21, 2, 3, [3])) == PackedByteArray([1, 2, 3]), "group with a duplicate reassembles")
+
+	check(server.receive_packet(PEER_ID, fragment(22, 0, 2, [1])).is_empty(), "first half before removing the peer")
+	server.remove_packet_peer(PEER_ID)
+	check(server.receive_packet(PEER_ID, fragment(22, 1, 2, [2])).is_empty(), "removing the peer drops its groups")
+	server.remove_packet_peer(PEER_ID)
+	server.remove_packet_peer(PEER_ID + 1)
+
+
+func verify_malformed_packets() -> void:
+	const PEER_ID = 4
+	check(server.receive_packet(PEER_ID, PackedByteArray([0, 1, 2])) == PackedByteArray([1, 2]), "entry packets are returned as batches")
+	check(server.receive_packet(PEER_ID, PackedByteArray()).is_empty(), "empty packet is dropped")
+	check(server.receive_packet(PEER_ID, PackedByteArray([7, 1])).is_empty(), "unknown packet type is dropped")
+	check(server.receive_packet(PEER_ID, PackedByteArray([1, 0, 0])).is_empty(), "truncated fragment header is dropped")
+	check(server.receive_packet(PEER_ID, fragment(30, 0, 0, [1])).is_empty(), "fragment count 0 is dropped")
+	check(server.receive_packet(PEER_ID, fragment(30, 2, 2, [1])).is_empty(), "fragment index beyond the count is dropped")
+
+	check(server.receive_packet(PEER_ID, fragment(31, 0, 2, [1])).is_empty(), "first of two")
+	check(server.receive_packet(PEER_ID, fragment(31, 1, 3, [2])).is_empty(), "fragment with a different count is dropped")
+	check(server.receive_packet(PEER_ID, fragment(31, 1, 2, [2])) == PackedByteArray([1, 2]), "group still reassembles after a mismatch")
+	server.remove_packet_peer(PEER_ID)
+
+
+func _initialize() -> void:
+	server = Engine.get_singleton("SceneSynchronizerServer")
+	server.phase_staggering = false
+
+	verify_gathered_fragments()
+	verify_assemblies()
+	verify_malformed_packets()
+
+	multiplayer_synchronizer.free()
+
+	if failures == 0:
+		print("Packet fragments: OK")
+	quit(failures)
@@ -0,0 +1,13 @@
+extends Node3D
+
+# Replication target for the SceneSynchronizer checks: one property of each kind the state codec encodes compactly,
+# plus an untyped one that is sent with a type tag.
+
+var count := 0
+var ratio := 0.0
+var flag := false
+var label := ""
+var offset := Vector3.ZERO
+var spin := Quaternion.IDENTITY
+var anything: Variant = 0
+var level := 0
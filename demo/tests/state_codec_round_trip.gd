@@ -0,0 +1,199 @@
+extends SceneTree
+
+# Round-trip check for the packed states SceneSynchronizer encodes: zigzag varints, typed and tagged values, delta
+# headers, bit packing and encoding profiles, and the errors malformed states must raise. Run from the repository root
+# with:
+#   godot --headless --path demo --script res://tests/state_codec_round_trip.gd
+# Exits with the number of failed checks.
+
+const ReplicatedStateNode = preload("res://tests/replicated_state_node.gd")
+
+const SYNC_PROPERTIES = [^":count", ^":ratio", ^":flag", ^":label", ^":offset", ^":spin", ^":anything"]
+# More than eight, so a single change is cheaper to send by index than with a mask.
+const WATCH_PROPERTIES = [^":level", ^":visible", ^":position:x", ^":position:y", ^":position:z", ^":scale:x", ^":scale:y", ^":scale:z", ^":rotation:y"]
+
+var failures := 0
+var multiplayer_synchronizer := MultiplayerSynchronizer.new()
+var sender: ReplicatedStateNode
+var receiver: ReplicatedStateNode
+var sender_sync: SceneSynchronizer
+var receiver_sync: SceneSynchronizer
+
+
+func check(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL: ", message)
+
+
+func build_config() -> SceneReplicationConfig:
+	var config := SceneReplicationConfig.new()
+	for path in SYNC_PROPERTIES:
+		config.add_property(path)
+	for path in WATCH_PROPERTIES:
+		config.add_property(path)
+		config.property_set_replication_mode(path, SceneReplicationConfig.REPLICATION_MODE_ON_CHANGE)
+	return config
+
+
+func add_synchronized_node() -> ReplicatedStateNode:
+	var node := ReplicatedStateNode.new()
+	var synchronizer := SceneSynchronizer.new()
+	synchronizer.name = "SceneSynchronizer"
+	synchronizer.multiplayer_synchronizer = multiplayer_synchronizer
+	synchronizer.root_path = ^".."
+	node.add_child(synchronizer)
+	root.add_child(node)
+	return node
+
+
+func sync_state() -> PackedByteArray:
+	return sender_sync.get_sync_state_packed(1, 0)
+
+
+func apply_sync_state(state: PackedByteArray) -> Error:
+	return receiver_sync.set_sync_state_packed(state)
+
+
+# Ints are zigzag varints: magnitudes up to 64 fit one byte, and the 64-bit extremes survive.
+func verify_ints() -> void:
+	for value in [0, 1, -1, 63, -64, 64, -65, 1 << 40, -(1 << 40), 9223372036854775807, -9223372036854775807 - 1]:
+		sender.count = value
+		receiver.count = ~value
+		check(apply_sync_state(sync_state()) == OK and receiver.count == value, "int %d round trip" % value)
+
+	sender.count = 63
+	var one_byte := sync_state().size()
+	sender.count = -64
+	check(sync_state().size() == one_byte, "-64 takes one byte")
+	sender.count = 64
+	check(sync_state().size() == one_byte + 1, "64 takes two bytes")
+	sender.count = -65
+	check(sync_state().size() == one_byte + 1, "-65 takes two bytes")
+	sender.count = 0
+
+
+func verify_values() -> void:
+	sender.ratio = 0.1
+	sender.flag = true
+	sender.label = "héllo wörld"
+	sender.offset = Vector3(1.5, -2.25, 3)
+	sender.spin = Quaternion(Vector3.UP, 0.5)
+	for value in [7, "seven", Vector2(1, 2), [1, "two"], {"three": 3}]:
+		sender.anything = value
+		check(apply_sync_state(sync_state()) == OK, "sync state with %s applies" % type_string(typeof(value)))
+		check(typeof(receiver.anything) == typeof(value) and receiver.anything == value, "tagged %s round trip" % type_string(typeof(value)))
+	check(receiver.ratio == 0.1, "float round trip")
+	check(receiver.flag, "bool round trip")
+	check(receiver.label == "héllo wörld", "string round trip")
+	check(receiver.offset == Vector3(1.5, -2.25, 3), "vector round trip")
+	check(receiver.spin.is_equal_approx(sender.spin), "quaternion round trip")
+
+
+func verify_sync_errors() -> void:
+	sender.anything = 7
+	var state := sync_state()
+	check(apply_sync_state(PackedByteArray()) == ERR_INVALID_DATA, "empty sync state fails")
+	check(apply_sync_state(state.slice(0, state.size() - 1)) == ERR_INVALID_DATA, "truncated sync state fails")
+
+	var trailing := state.duplicate()
+	trailing.append(0)
+	check(apply_sync_state(trailing) == ERR_INVALID_DATA, "sync state with trailing bytes fails")
+
+	# The untyped property comes last, as a type tag and a one byte varint.
+	var bad_tag := state.duplicate()
+	bad_tag[bad_tag.size() - 2] = 0xFF
+	check(apply_sync_state(bad_tag) == ERR_INVALID_DATA, "unknown type tag fails")
+
+
+# Delta headers are (changed << 1) | has_mask; the smaller of the mask and per-value indices is used.
+func verify_delta() -> void:
+	var state := sender_sync.get_delta_state_packed(1000, 0)
+	check(state.size() > 0 and state[0] == (WATCH_PROPERTIES.size() << 1) | 1, "first delta sends every watched property with a mask")
+	receiver.position = Vector3(9, 9, 9)
+	check(receiver_sync.set_delta_state_packed(state) == OK, "first delta applies")
+	check(receiver.position == sender.position and receiver.scale == sender.scale, "first delta round trip")
+
+	sender.level = 5
+	state = sender_sync.get_delta_state_packed(2000, 1000)
+	check(state == PackedByteArray([1 << 1, 0, 10]), "single change is sent by index")
+	check(receiver_sync.set_delta_state_packed(state) == OK and receiver.level == 5, "indexed delta round trip")
+
+	sender.position = Vector3(1, 2, 3)
+	sender.scale = Vector3(2, 2, 2)
+	state = sender_sync.get_delta_state_packed(3000, 2000)
+	check(state.size() > 0 and state[0] == (6 << 1) | 1, "many changes are sent with a mask")
+	check(receiver_sync.set_delta_state_packed(state) == OK, "masked delta applies")
+	check(receiver.position == Vector3(1, 2, 3) and receiver.scale == Vector3(2, 2, 2), "masked delta round trip")
+
+	state = sender_sync.get_delta_state_packed(4000, 3000)
+	check(state == PackedByteArray([0]), "unchanged delta is a single byte")
+	check(receiver_sync.set_delta_state_packed(state) == OK, "empty delta applies")
+
+	check(receiver_sync.set_delta_state_packed(PackedByteArray([1 << 1, WATCH_PROPERTIES.size(), 10])) == ERR_INVALID_DATA, "delta with an out of range index fails")
+	check(receiver_sync.set_delta_state_packed(PackedByteArray([(WATCH_PROPERTIES.size() + 1) << 1])) == ERR_INVALID_DATA, "delta with too many changes fails")
+	check(receiver_sync.set_delta_state_packed(PackedByteArray([(1 << 1) | 1, 1])) == ERR_INVALID_DATA, "delta with a truncated mask fails")
+	check(receiver_sync.set_delta_state_packed(PackedByteArray([1 << 1, 0])) == ERR_INVALID_DATA, "delta with a missing value fails")
+	check(receiver_sync.set_delta_state_packed(PackedByteArray([0, 0])) == ERR_INVALID_DATA, "delta with trailing bytes fails")
+
+
+func set_encoding(property: NodePath, encoding: SceneSynchronizer.PropertyEncoding, min_value := 0.0, max_value := 1.0, bits := 0) -> void:
+	sender_sync.set_property_encoding(property, encoding, min_value, max_value, bits)
+	receiver_sync.set_property_encoding(property, encoding, min_value, max_value, bits)
+
+
+func verify_encodings() -> void:
+	sender.count = -3
+	sender.flag = true
+	sender.ratio = 0.35
+	sender.offset = Vector3(1.5, -2.25, 100.125)
+	sender.spin = Quaternion(Vector3(1, 1, 0).normalized(), 2.0)
+	sender.anything = 2.5
+	var default_size := sync_state().size()
+
+	# A one-bit bool and a four-bit int share the byte either would have taken alone.
+	set_encoding(^":flag", SceneSynchronizer.PROPERTY_ENCODING_BITS)
+	set_encoding(^":count", SceneSynchronizer.PROPERTY_ENCODING_BITS, -8.0, 0.0, 4)
+	check(sync_state().size() == default_size - 1, "bits share a byte")
+	receiver.count = 0
+	receiver.flag = false
+	check(apply_sync_state(sync_state()) == OK and receiver.count == -3 and receiver.flag, "bits round trip")
+
+	set_encoding(^":ratio", SceneSynchronizer.PROPERTY_ENCODING_FIXED_POINT, 0.0, 1.0, 8)
+	set_encoding(^":offset", SceneSynchronizer.PROPERTY_ENCODING_HALF_FLOAT)
+	set_encoding(^":spin", SceneSynchronizer.PROPERTY_ENCODING_SMALLEST_THREE)
+	set_encoding(^":anything", SceneSynchronizer.PROPERTY_ENCODING_FIXED_POINT, -10.0, 10.0, 12)
+	var state := sync_state()
+	check(state.size() < default_size - 20, "encoding profiles shrink the state")
+	check(apply_sync_state(state) == OK, "encoded state applies")
+	check(absf(receiver.ratio - 0.35) <= 0.5 / 255.0, "fixed point within half a step")
+	check(receiver.offset == Vector3(1.5, -2.25, 100.125), "half floats keep representable values")
+	check(absf(receiver.spin.dot(sender.spin)) > 0.999, "smallest three keeps the rotation")
+	check(receiver.anything is float and absf(receiver.anything - 2.5) <= 10.0 / 4095.0, "tagged value uses its profile")
+
+	check(apply_sync_state(state.slice(0, state.size() - 1)) == ERR_INVALID_DATA, "truncated encoded state fails")
+
+	sender_sync.set_property_encoding(^":level", SceneSynchronizer.PROPERTY_ENCODING_BITS, 0.0, 1.0, 33)
+	check(not sender_sync.get_property_encodings().has(^":level"), "encoding with too many bits is rejected")
+
+
+func _initialize() -> void:
+	multiplayer_synchronizer.replication_config = build_config()
+	sender = add_synchronized_node()
+	receiver = add_synchronized_node()
+	sender_sync = sender.get_node("SceneSynchronizer")
+	receiver_sync = receiver.get_node("SceneSynchronizer")
+
+	verify_ints()
+	verify_values()
+	verify_sync_errors()
+	verify_delta()
+	verify_encodings()
+
+	sender.free()
+	receiver.free()
+	multiplayer_synchronizer.free()
+
+	if failures == 0:
+		print("State codec round trip: OK")
+	quit(failures)
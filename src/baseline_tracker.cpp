@@ -0,0 +1,107 @@
+#include "baseline_tracker.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+
+using namespace godot;
+
+void BaselineTracker::add_slot() {
+	slot_count++;
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		E.value.acked.push_back(0);
+	}
+}
+
+void BaselineTracker::remove_slot(uint32_t p_index) {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, slot_count);
+	const uint32_t last = --slot_count;
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		Peer &peer = E.value;
+		peer.acked[p_index] = peer.acked[last];
+		peer.acked.resize(last);
+
+		// Forget the removed slot and renumber the one moved into its place.
+		for (Pending &pending : peer.pending) {
+			uint32_t i = 0;
+			while (i < pending.slots.size()) {
+				if (pending.slots[i] == p_index) {
+					pending.slots[i] = pending.slots[pending.slots.size() - 1];
+					pending.slots.resize(pending.slots.size() - 1);
+					continue;
+				}
+				if (pending.slots[i] == last) {
+					pending.slots[i] = p_index;
+				}
+				i++;
+			}
+		}
+	}
+}
+
+void BaselineTracker::add_peer(int32_t p_peer_id) {
+	if (peers.has(p_peer_id)) {
+		return;
+	}
+	Peer &peer = peers[p_peer_id];
+	peer.acked.resize(slot_count);
+	for (uint32_t &id : peer.acked) {
+		id = 0;
+	}
+}
+
+void BaselineTracker::remove_peer(int32_t p_peer_id) {
+	peers.erase(p_peer_id);
+}
+
+uint32_t BaselineTracker::next_snapshot_id() {
+	const uint32_t id = next_id++;
+	if (next_id == 0) {
+		// 0 is reserved for "no baseline".
+		next_id = 1;
+	}
+	return id;
+}
+
+void BaselineTracker::add_pending(Peer &r_peer, Pending &&p_pending) {
+	if (r_peer.pending.size() >= MAX_PENDING) {
+		r_peer.pending.remove_at(0);
+	}
+	r_peer.pending.push_back(std::move(p_pending));
+}
+
+void BaselineTracker::acknowledge(int32_t p_peer_id, uint32_t p_snapshot_id) {
+	Peer *peer = peers.getptr(p_peer_id);
+	ERR_FAIL_NULL_MSG(peer, vformat("Baseline peer %d is not registered.", p_peer_id));
+
+	for (uint32_t i = 0; i < peer->pending.size(); i++) {
+		if (peer->pending[i].id != p_snapshot_id) {
+			continue;
+		}
+		for (const uint32_t slot : peer->pending[i].slots) {
+			peer->acked[slot] = p_snapshot_id;
+		}
+		// Older snapshots can no longer become baselines once a newer one is acknowledged.
+		for (uint32_t j = 0; j <= i; j++) {
+			peer->pending.remove_at(0);
+		}
+		return;
+	}
+}
+
+// Drops a slot's baseline for a peer that could not apply it, so the next snapshot carries its full state. The slot is
+// also removed from snapshots in flight, which were encoded against the baseline being dropped.
+void BaselineTracker::reset_slot(int32_t p_peer_id, uint32_t p_index) {
+	Peer *peer = peers.getptr(p_peer_id);
+	ERR_FAIL_NULL_MSG(peer, vformat("Baseline peer %d is not registered.", p_peer_id));
+	ERR_FAIL_UNSIGNED_INDEX(p_index, slot_count);
+
+	peer->acked[p_index] = 0;
+	for (Pending &pending : peer->pending) {
+		for (uint32_t i = 0; i < pending.slots.size(); i++) {
+			if (pending.slots[i] == p_index) {
+				pending.slots[i] = pending.slots[pending.slots.size() - 1];
+				pending.slots.resize(pending.slots.size() - 1);
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+namespace godot {
+
+// Per-peer acknowledgement state for baseline delta compression. Every snapshot sent to a peer is remembered with the
+// slots it contained until the peer acknowledges it (or it falls out of the window); an acknowledgement makes that
+// snapshot the peer's baseline for those slots. Slots mirror SceneSynchronizerServer's arrays.
+class BaselineTracker {
+public:
+	static constexpr uint32_t MAX_PENDING = 64;
+
+	struct Pending {
+		uint32_t id = 0;
+		LocalVector<uint32_t> slots;
+	};
+
+	struct Peer {
+		// Acknowledged snapshot id per slot, 0 when there is no baseline.
+		LocalVector<uint32_t> acked;
+		LocalVector<Pending> pending;
+	};
+
+private:
+	uint32_t slot_count = 0;
+	uint32_t next_id = 1;
+	HashMap<int32_t, Peer> peers;
+
+public:
+	void add_slot();
+	void remove_slot(uint32_t p_index);
+
+	void add_peer(int32_t p_peer_id);
+	void remove_peer(int32_t p_peer_id);
+	bool has_peer(int32_t p_peer_id) const { return peers.has(p_peer_id); }
+	HashMap<int32_t, Peer> &get_peers() { return peers; }
+
+	uint32_t next_snapshot_id();
+	void add_pending(Peer &r_peer, Pending &&p_pending);
+	void acknowledge(int32_t p_peer_id, uint32_t p_snapshot_id);
+	void reset_slot(int32_t p_peer_id, uint32_t p_index);
+};
+
+} //namespace godot
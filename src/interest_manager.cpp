@@ -0,0 +1,222 @@
+#include "interest_manager.h"
+
+#include "scene_synchronizer.h"
+
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+
+using namespace godot;
+
+// Cells are packed as three 21-bit coordinates, which never collides with the sentinel keys.
+static constexpr int64_t CELL_COORD_MASK = (1 << 21) - 1;
+
+uint64_t InterestManager::_get_cell_key(const Vector3 &p_position) const {
+	const int64_t x = int64_t(Math::floor(p_position.x / cell_size)) & CELL_COORD_MASK;
+	const int64_t y = int64_t(Math::floor(p_position.y / cell_size)) & CELL_COORD_MASK;
+	const int64_t z = int64_t(Math::floor(p_position.z / cell_size)) & CELL_COORD_MASK;
+	return uint64_t(x) | (uint64_t(y) << 21) | (uint64_t(z) << 42);
+}
+
+void InterestManager::_remove_from_cell(uint64_t p_cell, uint32_t p_index) {
+	LocalVector<uint32_t> *bucket = grid.getptr(p_cell);
+	if (!bucket) {
+		return;
+	}
+	for (uint32_t i = 0; i < bucket->size(); i++) {
+		if ((*bucket)[i] == p_index) {
+			(*bucket)[i] = (*bucket)[bucket->size() - 1];
+			bucket->resize(bucket->size() - 1);
+			break;
+		}
+	}
+	if (bucket->is_empty()) {
+		grid.erase(p_cell);
+	}
+}
+
+void InterestManager::add_slot() {
+	positions.push_back(Vector3());
+	cells.push_back(NO_CELL);
+	relevant.push_back(0);
+}
+
+void InterestManager::remove_slot(uint32_t p_index, SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, cells.size());
+	_remove_from_cell(cells[p_index], p_index);
+
+	const uint32_t last = cells.size() - 1;
+	if (p_index != last) {
+		// Renumber the moved slot in its bucket.
+		if (LocalVector<uint32_t> *bucket = grid.getptr(cells[last])) {
+			for (uint32_t &index : *bucket) {
+				if (index == last) {
+					index = p_index;
+					break;
+				}
+			}
+		}
+		positions[p_index] = positions[last];
+		cells[p_index] = cells[last];
+		relevant[p_index] = relevant[last];
+	}
+	positions.resize(last);
+	cells.resize(last);
+	relevant.resize(last);
+
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		Peer &peer = E.value;
+		peer.relevant.erase(p_synchronizer);
+		peer.tiers.erase(p_synchronizer);
+		peer.entered.erase(p_synchronizer);
+		peer.exited.erase(p_synchronizer);
+	}
+}
+
+void InterestManager::set_cell_size(real_t p_size) {
+	ERR_FAIL_COND_MSG(p_size <= 0, "Interest cell size must be greater than 0.");
+	cell_size = p_size;
+	// Everything is re-bucketed on the next update.
+	grid.clear();
+	for (uint64_t &cell : cells) {
+		cell = NO_CELL;
+	}
+}
+
+void InterestManager::set_peer(int32_t p_peer_id, const Vector3 &p_origin, real_t p_radius) {
+	Peer &peer = peers[p_peer_id];
+	peer.origin = p_origin;
+	peer.radius = p_radius;
+}
+
+void InterestManager::set_peer_filter(int32_t p_peer_id, const Callable &p_filter) {
+	Peer *peer = peers.getptr(p_peer_id);
+	ERR_FAIL_NULL_MSG(peer, vformat("Interest peer %d is not registered.", p_peer_id));
+	peer->filter = p_filter;
+}
+
+void InterestManager::remove_peer(int32_t p_peer_id) {
+	peers.erase(p_peer_id);
+}
+
+void InterestManager::update(const LocalVector<SceneSynchronizer *> &p_synchronizers) {
+	ERR_FAIL_COND(p_synchronizers.size() != cells.size());
+
+	for (uint32_t i = 0; i < p_synchronizers.size(); i++) {
+		Node *root = p_synchronizers[i]->get_root_node();
+		uint64_t cell = UNBOUNDED_CELL;
+		if (const Node3D *node_3d = Object::cast_to<Node3D>(root)) {
+			positions[i] = node_3d->get_global_position();
+			cell = _get_cell_key(positions[i]);
+		} else if (const Node2D *node_2d = Object::cast_to<Node2D>(root)) {
+			const Vector2 position = node_2d->get_global_position();
+			positions[i] = Vector3(position.x, position.y, 0);
+			cell = _get_cell_key(positions[i]);
+		}
+		if (cell != cells[i]) {
+			_remove_from_cell(cells[i], i);
+			grid[cell].push_back(i);
+			cells[i] = cell;
+		}
+		relevant[i] = 0;
+	}
+
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		_update_peer(E.key, E.value, p_synchronizers);
+	}
+}
+
+uint8_t InterestManager::_get_rate_tier(int32_t p_peer_id, SceneSynchronizer *p_synchronizer, real_t p_distance_squared) const {
+	if (rate_tier_callback.is_valid()) {
+		const int64_t tier = rate_tier_callback.call(p_peer_id, p_synchronizer, Math::sqrt(p_distance_squared));
+		return CLAMP(tier, int64_t(RATE_TIER_FULL), int64_t(RATE_TIER_MAX - 1));
+	}
+	if (quarter_rate_distance > 0 && p_distance_squared >= quarter_rate_distance * quarter_rate_distance) {
+		return RATE_TIER_QUARTER;
+	}
+	if (half_rate_distance > 0 && p_distance_squared >= half_rate_distance * half_rate_distance) {
+		return RATE_TIER_HALF;
+	}
+	return RATE_TIER_FULL;
+}
+
+void InterestManager::_update_peer(int32_t p_peer_id, Peer &r_peer, const LocalVector<SceneSynchronizer *> &p_synchronizers) {
+	HashSet<SceneSynchronizer *> next;
+	const real_t radius_squared = r_peer.radius * r_peer.radius;
+	const bool unlimited = r_peer.radius <= 0;
+
+	r_peer.tiers.clear();
+
+	auto consider = [&](uint32_t p_index, bool p_bounded) {
+		// Synchronizers without a spatial root count as being at the peer's origin.
+		const real_t distance_squared = p_bounded ? r_peer.origin.distance_squared_to(positions[p_index]) : 0;
+		if (p_bounded && !unlimited && distance_squared > radius_squared) {
+			return;
+		}
+		SceneSynchronizer *synchronizer = p_synchronizers[p_index];
+		if (r_peer.filter.is_valid() && !bool(r_peer.filter.call(p_peer_id, synchronizer))) {
+			return;
+		}
+		next.insert(synchronizer);
+		relevant[p_index] = 1;
+
+		const uint8_t tier = _get_rate_tier(p_peer_id, synchronizer, distance_squared);
+		if (tier != RATE_TIER_FULL) {
+			r_peer.tiers.insert(synchronizer, tier);
+		}
+	};
+
+	if (const LocalVector<uint32_t> *bucket = grid.getptr(UNBOUNDED_CELL)) {
+		for (const uint32_t index : *bucket) {
+			consider(index, false);
+		}
+	}
+
+	const int64_t min_x = int64_t(Math::floor((r_peer.origin.x - r_peer.radius) / cell_size));
+	const int64_t max_x = int64_t(Math::floor((r_peer.origin.x + r_peer.radius) / cell_size));
+	const int64_t min_y = int64_t(Math::floor((r_peer.origin.y - r_peer.radius) / cell_size));
+	const int64_t max_y = int64_t(Math::floor((r_peer.origin.y + r_peer.radius) / cell_size));
+	const int64_t min_z = int64_t(Math::floor((r_peer.origin.z - r_peer.radius) / cell_size));
+	const int64_t max_z = int64_t(Math::floor((r_peer.origin.z + r_peer.radius) / cell_size));
+	const double cell_count = double(max_x - min_x + 1) * double(max_y - min_y + 1) * double(max_z - min_z + 1);
+
+	if (unlimited || cell_count >= grid.size()) {
+		// Cheaper to test every occupied cell than to probe the covered ones.
+		for (const KeyValue<uint64_t, LocalVector<uint32_t>> &E : grid) {
+			if (E.key == UNBOUNDED_CELL) {
+				continue;
+			}
+			for (const uint32_t index : E.value) {
+				consider(index, true);
+			}
+		}
+	} else {
+		for (int64_t z = min_z; z <= max_z; z++) {
+			for (int64_t y = min_y; y <= max_y; y++) {
+				for (int64_t x = min_x; x <= max_x; x++) {
+					const uint64_t key = uint64_t(x & CELL_COORD_MASK) | (uint64_t(y & CELL_COORD_MASK) << 21) | (uint64_t(z & CELL_COORD_MASK) << 42);
+					const LocalVector<uint32_t> *bucket = grid.getptr(key);
+					if (!bucket) {
+						continue;
+					}
+					for (const uint32_t index : *bucket) {
+						consider(index, true);
+					}
+				}
+			}
+		}
+	}
+
+	r_peer.entered.clear();
+	r_peer.exited.clear();
+	for (SceneSynchronizer *synchronizer : next) {
+		if (!r_peer.relevant.has(synchronizer)) {
+			r_peer.entered.push_back(synchronizer);
+		}
+	}
+	for (SceneSynchronizer *synchronizer : r_peer.relevant) {
+		if (!next.has(synchronizer)) {
+			r_peer.exited.push_back(synchronizer);
+		}
+	}
+	r_peer.relevant = next;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+namespace godot {
+
+class SceneSynchronizer;
+
+// Per-peer relevance of synchronizers. Root node positions are bucketed in a sparse uniform grid that is updated
+// incrementally as nodes cross cell boundaries, and each peer queries only the cells overlapping its view radius.
+// Synchronizers without a Node2D/Node3D root are relevant to every peer. Slots mirror SceneSynchronizerServer's arrays.
+class InterestManager {
+public:
+	// Fraction of the normal replication rate a peer receives a synchronizer at.
+	enum RateTier : uint8_t {
+		RATE_TIER_FULL,
+		RATE_TIER_HALF,
+		RATE_TIER_QUARTER,
+		RATE_TIER_MAX,
+	};
+
+	struct Peer {
+		Vector3 origin;
+		// Zero or less means unlimited.
+		real_t radius = 0;
+		// Optional `func(peer_id: int, synchronizer: SceneSynchronizer) -> bool`, applied after the radius test.
+		Callable filter;
+		HashSet<SceneSynchronizer *> relevant;
+		// Relevant synchronizers below full rate.
+		HashMap<SceneSynchronizer *, uint8_t> tiers;
+		LocalVector<SceneSynchronizer *> entered;
+		LocalVector<SceneSynchronizer *> exited;
+	};
+
+private:
+	static constexpr uint64_t NO_CELL = UINT64_MAX;
+	static constexpr uint64_t UNBOUNDED_CELL = UINT64_MAX - 1;
+
+	real_t cell_size = 64.0;
+	// Zero disables the tier.
+	real_t half_rate_distance = 0;
+	real_t quarter_rate_distance = 0;
+	// Optional `func(peer_id: int, synchronizer: SceneSynchronizer, distance: float) -> int` returning a RateTier, used
+	// instead of the distances.
+	Callable rate_tier_callback;
+	HashMap<uint64_t, LocalVector<uint32_t>> grid;
+	HashMap<int32_t, Peer> peers;
+	LocalVector<Vector3> positions;
+	LocalVector<uint64_t> cells;
+	LocalVector<uint8_t> relevant;
+
+	uint64_t _get_cell_key(const Vector3 &p_position) const;
+	uint8_t _get_rate_tier(int32_t p_peer_id, SceneSynchronizer *p_synchronizer, real_t p_distance_squared) const;
+	void _remove_from_cell(uint64_t p_cell, uint32_t p_index);
+	void _update_peer(int32_t p_peer_id, Peer &r_peer, const LocalVector<SceneSynchronizer *> &p_synchronizers);
+
+public:
+	void add_slot();
+	void remove_slot(uint32_t p_index, SceneSynchronizer *p_synchronizer);
+
+	void set_cell_size(real_t p_size);
+	real_t get_cell_size() const { return cell_size; }
+
+	void set_half_rate_distance(real_t p_distance) { half_rate_distance = p_distance; }
+	real_t get_half_rate_distance() const { return half_rate_distance; }
+	void set_quarter_rate_distance(real_t p_distance) { quarter_rate_distance = p_distance; }
+	real_t get_quarter_rate_distance() const { return quarter_rate_distance; }
+	void set_rate_tier_callback(const Callable &p_callback) { rate_tier_callback = p_callback; }
+	Callable get_rate_tier_callback() const { return rate_tier_callback; }
+
+	void set_peer(int32_t p_peer_id, const Vector3 &p_origin, real_t p_radius);
+	void set_peer_filter(int32_t p_peer_id, const Callable &p_filter);
+	void remove_peer(int32_t p_peer_id);
+	const Peer *get_peer(int32_t p_peer_id) const { return peers.getptr(p_peer_id); }
+	const HashMap<int32_t, Peer> &get_peers() const { return peers; }
+
+	// Interest is only applied once at least one peer is registered.
+	bool is_enabled() const { return !peers.is_empty(); }
+	bool is_relevant(uint32_t p_index) const { return peers.is_empty() || relevant[p_index]; }
+	// Peers without an interest registration see everything.
+	bool is_relevant_to(int32_t p_peer_id, SceneSynchronizer *p_synchronizer) const {
+		const Peer *peer = peers.getptr(p_peer_id);
+		return !peer || peer->relevant.has(p_synchronizer);
+	}
+	static uint8_t get_rate_tier(const Peer *p_peer, SceneSynchronizer *p_synchronizer) {
+		const uint8_t *tier = p_peer ? p_peer->tiers.getptr(p_synchronizer) : nullptr;
+		return tier ? *tier : uint8_t(RATE_TIER_FULL);
+	}
+
+	void update(const LocalVector<SceneSynchronizer *> &p_synchronizers);
+};
+
+} //namespace godot
@@ -0,0 +1,224 @@
+#include "native_accessor.h"
+
+#include <godot_cpp/classes/canvas_item.hpp>
+#include <godot_cpp/classes/character_body2d.hpp>
+#include <godot_cpp/classes/character_body3d.hpp>
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/rigid_body2d.hpp>
+#include <godot_cpp/classes/rigid_body3d.hpp>
+
+using namespace godot;
+
+NativeAccessor::Type NativeAccessor::resolve(const Object *p_obj, const StringName &p_property) {
+	if (!p_obj) {
+		return NONE;
+	}
+	// Resolution only happens when a replication plan is first bound, so temporary names are fine here.
+	const String name(p_property);
+
+	if (Object::cast_to<RigidBody2D>(p_obj)) {
+		if (name == "linear_velocity") {
+			return RIGID_BODY_2D_LINEAR_VELOCITY;
+		}
+		if (name == "angular_velocity") {
+			return RIGID_BODY_2D_ANGULAR_VELOCITY;
+		}
+	} else if (Object::cast_to<RigidBody3D>(p_obj)) {
+		if (name == "linear_velocity") {
+			return RIGID_BODY_3D_LINEAR_VELOCITY;
+		}
+		if (name == "angular_velocity") {
+			return RIGID_BODY_3D_ANGULAR_VELOCITY;
+		}
+	} else if (Object::cast_to<CharacterBody2D>(p_obj)) {
+		if (name == "velocity") {
+			return CHARACTER_BODY_2D_VELOCITY;
+		}
+	} else if (Object::cast_to<CharacterBody3D>(p_obj)) {
+		if (name == "velocity") {
+			return CHARACTER_BODY_3D_VELOCITY;
+		}
+	}
+
+	if (Object::cast_to<Node2D>(p_obj)) {
+		if (name == "position") {
+			return NODE_2D_POSITION;
+		}
+		if (name == "rotation") {
+			return NODE_2D_ROTATION;
+		}
+		if (name == "scale") {
+			return NODE_2D_SCALE;
+		}
+	} else if (Object::cast_to<Node3D>(p_obj)) {
+		if (name == "position") {
+			return NODE_3D_POSITION;
+		}
+		if (name == "rotation") {
+			return NODE_3D_ROTATION;
+		}
+		if (name == "quaternion") {
+			return NODE_3D_QUATERNION;
+		}
+		if (name == "scale") {
+			return NODE_3D_SCALE;
+		}
+		if (name == "visible") {
+			return NODE_3D_VISIBLE;
+		}
+	}
+
+	if (Object::cast_to<CanvasItem>(p_obj) && name == "visible") {
+		return CANVAS_ITEM_VISIBLE;
+	}
+	return NONE;
+}
+
+int8_t NativeAccessor::resolve_component(const StringName &p_subname) {
+	const String name(p_subname);
+	if (name == "x") {
+		return 0;
+	}
+	if (name == "y") {
+		return 1;
+	}
+	if (name == "z") {
+		return 2;
+	}
+	if (name == "w") {
+		return 3;
+	}
+	return -1;
+}
+
+// Accessors are only used on the object they were resolved from, so the casts below are unchecked.
+Variant NativeAccessor::get(Type p_type, const Object *p_obj) {
+	switch (p_type) {
+		case NONE:
+			break;
+		case CANVAS_ITEM_VISIBLE:
+			return static_cast<const CanvasItem *>(p_obj)->is_visible();
+		case NODE_2D_POSITION:
+			return static_cast<const Node2D *>(p_obj)->get_position();
+		case NODE_2D_ROTATION:
+			return static_cast<const Node2D *>(p_obj)->get_rotation();
+		case NODE_2D_SCALE:
+			return static_cast<const Node2D *>(p_obj)->get_scale();
+		case NODE_3D_POSITION:
+			return static_cast<const Node3D *>(p_obj)->get_position();
+		case NODE_3D_ROTATION:
+			return static_cast<const Node3D *>(p_obj)->get_rotation();
+		case NODE_3D_QUATERNION:
+			return static_cast<const Node3D *>(p_obj)->get_quaternion();
+		case NODE_3D_SCALE:
+			return static_cast<const Node3D *>(p_obj)->get_scale();
+		case NODE_3D_VISIBLE:
+			return static_cast<const Node3D *>(p_obj)->is_visible();
+		case CHARACTER_BODY_2D_VELOCITY:
+			return static_cast<const CharacterBody2D *>(p_obj)->get_velocity();
+		case CHARACTER_BODY_3D_VELOCITY:
+			return static_cast<const CharacterBody3D *>(p_obj)->get_velocity();
+		case RIGID_BODY_2D_LINEAR_VELOCITY:
+			return static_cast<const RigidBody2D *>(p_obj)->get_linear_velocity();
+		case RIGID_BODY_2D_ANGULAR_VELOCITY:
+			return static_cast<const RigidBody2D *>(p_obj)->get_angular_velocity();
+		case RIGID_BODY_3D_LINEAR_VELOCITY:
+			return static_cast<const RigidBody3D *>(p_obj)->get_linear_velocity();
+		case RIGID_BODY_3D_ANGULAR_VELOCITY:
+			return static_cast<const RigidBody3D *>(p_obj)->get_angular_velocity();
+	}
+	return Variant();
+}
+
+void NativeAccessor::set(Type p_type, Object *p_obj, const Variant &p_value) {
+	switch (p_type) {
+		case NONE:
+			break;
+		case CANVAS_ITEM_VISIBLE:
+			static_cast<CanvasItem *>(p_obj)->set_visible(p_value);
+			break;
+		case NODE_2D_POSITION:
+			static_cast<Node2D *>(p_obj)->set_position(p_value);
+			break;
+		case NODE_2D_ROTATION:
+			static_cast<Node2D *>(p_obj)->set_rotation(p_value);
+			break;
+		case NODE_2D_SCALE:
+			static_cast<Node2D *>(p_obj)->set_scale(p_value);
+			break;
+		case NODE_3D_POSITION:
+			static_cast<Node3D *>(p_obj)->set_position(p_value);
+			break;
+		case NODE_3D_ROTATION:
+			static_cast<Node3D *>(p_obj)->set_rotation(p_value);
+			break;
+		case NODE_3D_QUATERNION:
+			static_cast<Node3D *>(p_obj)->set_quaternion(p_value);
+			break;
+		case NODE_3D_SCALE:
+			static_cast<Node3D *>(p_obj)->set_scale(p_value);
+			break;
+		case NODE_3D_VISIBLE:
+			static_cast<Node3D *>(p_obj)->set_visible(p_value);
+			break;
+		case CHARACTER_BODY_2D_VELOCITY:
+			static_cast<CharacterBody2D *>(p_obj)->set_velocity(p_value);
+			break;
+		case CHARACTER_BODY_3D_VELOCITY:
+			static_cast<CharacterBody3D *>(p_obj)->set_velocity(p_value);
+			break;
+		case RIGID_BODY_2D_LINEAR_VELOCITY:
+			static_cast<RigidBody2D *>(p_obj)->set_linear_velocity(p_value);
+			break;
+		case RIGID_BODY_2D_ANGULAR_VELOCITY:
+			static_cast<RigidBody2D *>(p_obj)->set_angular_velocity(p_value);
+			break;
+		case RIGID_BODY_3D_LINEAR_VELOCITY:
+			static_cast<RigidBody3D *>(p_obj)->set_linear_velocity(p_value);
+			break;
+		case RIGID_BODY_3D_ANGULAR_VELOCITY:
+			static_cast<RigidBody3D *>(p_obj)->set_angular_velocity(p_value);
+			break;
+	}
+}
+
+Variant NativeAccessor::get_component(const Variant &p_value, int8_t p_component) {
+	switch (p_value.get_type()) {
+		case Variant::VECTOR2:
+			return p_component < 2 ? Variant(Vector2(p_value)[p_component]) : Variant();
+		case Variant::VECTOR3:
+			return p_component < 3 ? Variant(Vector3(p_value)[p_component]) : Variant();
+		case Variant::QUATERNION:
+			return Variant(Quaternion(p_value)[p_component]);
+		default:
+			return Variant();
+	}
+}
+
+bool NativeAccessor::set_component(Variant &r_value, int8_t p_component, const Variant &p_component_value) {
+	switch (r_value.get_type()) {
+		case Variant::VECTOR2: {
+			ERR_FAIL_COND_V(p_component >= 2, false);
+			Vector2 v = r_value;
+			v[p_component] = p_component_value;
+			r_value = v;
+		}
+			return true;
+		case Variant::VECTOR3: {
+			ERR_FAIL_COND_V(p_component >= 3, false);
+			Vector3 v = r_value;
+			v[p_component] = p_component_value;
+			r_value = v;
+		}
+			return true;
+		case Variant::QUATERNION: {
+			Quaternion q = r_value;
+			q[p_component] = p_component_value;
+			r_value = q;
+		}
+			return true;
+		default:
+			return false;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <godot_cpp/classes/object.hpp>
+
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+namespace godot {
+
+// Typed access to the engine properties replicated most often. Calling the class's own getter or setter goes straight
+// to its cached method bind instead of looking the property up by name through Object::get/set. Vector sub-properties
+// (e.g. position:x) are addressed by component index.
+class NativeAccessor {
+public:
+	enum Type : uint8_t {
+		NONE,
+		CANVAS_ITEM_VISIBLE,
+		NODE_2D_POSITION,
+		NODE_2D_ROTATION,
+		NODE_2D_SCALE,
+		NODE_3D_POSITION,
+		NODE_3D_ROTATION,
+		NODE_3D_QUATERNION,
+		NODE_3D_SCALE,
+		NODE_3D_VISIBLE,
+		CHARACTER_BODY_2D_VELOCITY,
+		CHARACTER_BODY_3D_VELOCITY,
+		RIGID_BODY_2D_LINEAR_VELOCITY,
+		RIGID_BODY_2D_ANGULAR_VELOCITY,
+		RIGID_BODY_3D_LINEAR_VELOCITY,
+		RIGID_BODY_3D_ANGULAR_VELOCITY,
+	};
+
+	static Type resolve(const Object *p_obj, const StringName &p_property);
+	static int8_t resolve_component(const StringName &p_subname);
+
+	static Variant get(Type p_type, const Object *p_obj);
+	static void set(Type p_type, Object *p_obj, const Variant &p_value);
+
+	static Variant get_component(const Variant &p_value, int8_t p_component);
+	static bool set_component(Variant &r_value, int8_t p_component, const Variant &p_component_value);
+};
+
+} //namespace godot
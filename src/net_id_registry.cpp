@@ -0,0 +1,91 @@
+#include "net_id_registry.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+
+using namespace godot;
+
+void NetIdRegistry::_resize(uint32_t p_capacity) {
+	const LocalVector<Entry> old = entries;
+	entries.clear();
+	entries.resize(p_capacity);
+
+	uint32_t bits = 0;
+	while ((1u << bits) < p_capacity) {
+		bits++;
+	}
+	shift = 32 - bits;
+
+	count = 0;
+	for (const Entry &E : old) {
+		if (E.net_id != 0) {
+			insert(E.net_id, E.synchronizer);
+		}
+	}
+}
+
+void NetIdRegistry::insert(uint32_t p_net_id, SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_COND(p_net_id == 0);
+	if ((count + 1) * 2 > entries.size()) {
+		_resize(MAX(MIN_CAPACITY, entries.size() * 2));
+	}
+
+	const uint32_t mask = entries.size() - 1;
+	uint32_t slot = _get_slot(p_net_id);
+	while (entries[slot].net_id != 0) {
+		if (entries[slot].net_id == p_net_id) {
+			WARN_PRINT(vformat("Net ID %d was already assigned to another SceneSynchronizer.", p_net_id));
+			entries[slot].synchronizer = p_synchronizer;
+			return;
+		}
+		slot = (slot + 1) & mask;
+	}
+	entries[slot].net_id = p_net_id;
+	entries[slot].synchronizer = p_synchronizer;
+	count++;
+}
+
+void NetIdRegistry::remove(uint32_t p_net_id, const SceneSynchronizer *p_synchronizer) {
+	if (p_net_id == 0 || count == 0) {
+		return;
+	}
+	const uint32_t mask = entries.size() - 1;
+	uint32_t slot = _get_slot(p_net_id);
+	while (entries[slot].net_id != p_net_id) {
+		if (entries[slot].net_id == 0) {
+			return;
+		}
+		slot = (slot + 1) & mask;
+	}
+	if (entries[slot].synchronizer != p_synchronizer) {
+		return;
+	}
+
+	// Shift later members of the probe run back so every entry stays reachable from its home slot.
+	uint32_t hole = slot;
+	uint32_t next = (hole + 1) & mask;
+	while (entries[next].net_id != 0) {
+		const uint32_t home = _get_slot(entries[next].net_id);
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			entries[hole] = entries[next];
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	entries[hole] = Entry();
+	count--;
+}
+
+SceneSynchronizer *NetIdRegistry::lookup(uint32_t p_net_id) const {
+	if (p_net_id == 0 || count == 0) {
+		return nullptr;
+	}
+	const uint32_t mask = entries.size() - 1;
+	uint32_t slot = _get_slot(p_net_id);
+	while (entries[slot].net_id != 0) {
+		if (entries[slot].net_id == p_net_id) {
+			return entries[slot].synchronizer;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return nullptr;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+namespace godot {
+
+class SceneSynchronizer;
+
+// Open-addressing table from net ID to synchronizer for routing inbound entries. Linear probing over a power-of-two
+// table kept at most half full, with backward-shift deletion so lookups never have to skip tombstones. Net ID 0 means
+// unassigned and is never stored.
+class NetIdRegistry {
+private:
+	struct Entry {
+		uint32_t net_id = 0;
+		SceneSynchronizer *synchronizer = nullptr;
+	};
+
+	static constexpr uint32_t MIN_CAPACITY = 64;
+
+	LocalVector<Entry> entries;
+	uint32_t count = 0;
+	uint32_t shift = 32;
+
+	uint32_t _get_slot(uint32_t p_net_id) const { return (p_net_id * 2654435769u) >> shift; }
+	void _resize(uint32_t p_capacity);
+
+public:
+	void insert(uint32_t p_net_id, SceneSynchronizer *p_synchronizer);
+	// Only removes the entry if it still belongs to p_synchronizer.
+	void remove(uint32_t p_net_id, const SceneSynchronizer *p_synchronizer);
+	SceneSynchronizer *lookup(uint32_t p_net_id) const;
+	uint32_t size() const { return count; }
+};
+
+} //namespace godot
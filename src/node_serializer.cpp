@@ -197,8 +197,25 @@ Variant NodeSerializer::serialize_to_binary_structure(const Variant &p_value, co
 	return result;
 }
 
+// Streams the value straight into the output buffer while walking objects and properties, without building the
+// intermediate structure that serialize_to_binary_structure() returns.
 PackedByteArray NodeSerializer::serialize_to_binary(const Variant &p_value, const Dictionary &p_options) {
-	return UtilityFunctions::var_to_bytes(serialize_to_binary_structure(p_value, p_options));
+	INSTRUMENT_FUNCTION_START("serialize_to_binary");
+	SerializationContext context;
+	context.serialize_value = &_serialize_recursively;
+	_apply_serialization_context_options(context, p_options);
+	BinarySchema schema;
+	context.schema = &schema;
+	StateWriter writer;
+	writer.put_u32(BINARY_MAGIC | (uint32_t(BINARY_VERSION) << 24));
+	// Offset of the schema table, which follows the value once every name in it is known.
+	writer.put_u32(0);
+	_write_value(writer, p_value, context);
+	writer.patch_u32(4, uint32_t(writer.get_position()));
+	schema.write(writer);
+	PackedByteArray result = writer.finish();
+	INSTRUMENT_FUNCTION_END();
+	return result;
 }
 
 Variant NodeSerializer::deserialize_from_binary_structure(const Variant &p_value, const Dictionary &p_options) {
@@ -212,7 +229,36 @@ Variant NodeSerializer::deserialize_from_binary_structure(const Variant &p_value
 }
 
 Variant NodeSerializer::deserialize_from_binary(const PackedByteArray &p_bytes, const Dictionary &p_options) {
-	return deserialize_from_binary_structure(UtilityFunctions::bytes_to_var(p_bytes), p_options);
+	StateReader reader(p_bytes);
+	const uint32_t header = p_bytes.size() >= 4 ? reader.get_u32() : 0;
+	if ((header & 0xFFFFFF) != BINARY_MAGIC) {
+		return deserialize_from_binary_structure(UtilityFunctions::bytes_to_var(p_bytes), p_options);
+	}
+	const uint32_t version = header >> 24;
+	ERR_FAIL_COND_V_MSG(version != BINARY_VERSION, Variant(), vformat("Unsupported binary serialization version %d.", version));
+
+	INSTRUMENT_FUNCTION_START("deserialize_from_binary");
+	DeserializationContext context;
+	context.deserialize_value = &_deserialize_recursively;
+	_apply_deserialization_context_options(context, p_options);
+
+	BinarySchema schema;
+	const int64_t value_end = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || value_end < reader.get_position() || value_end > p_bytes.size(), Variant(), "Invalid binary serialization schema offset.");
+	StateReader schema_reader(p_bytes);
+	schema_reader.skip(value_end);
+	ERR_FAIL_COND_V_MSG(schema.read(schema_reader) != OK, Variant(), "Invalid binary serialization schema.");
+	context.schema = &schema;
+
+	Variant result;
+	const Error err = _read_value(reader, context, result);
+	INSTRUMENT_FUNCTION_END();
+	ERR_FAIL_COND_V_MSG(err != OK, Variant(), "Failed to deserialize binary data.");
+	if (reader.get_position() != value_end) {
+		_free_partial_value(result);
+		ERR_FAIL_V_MSG(Variant(), "Trailing bytes after binary serialized value.");
+	}
+	return result;
 }
 
 void NodeSerializer::_apply_serialization_context_options(SerializationContext &p_context, const Dictionary &p_options) {
@@ -487,6 +533,445 @@ void NodeSerializer::_deserialize_children(Node *node, const Dictionary &p_seria
 	}
 }
 
+uint32_t NodeSerializer::BinarySchema::get_type_id(const ObjectRegistration *p_registration) {
+	if (const uint32_t *id = type_ids.getptr(p_registration)) {
+		return *id;
+	}
+	const uint32_t id = types.size();
+	types.push_back(Type());
+	types[id].name = p_registration->name;
+	types[id].registration = p_registration;
+	type_ids.insert(p_registration, id);
+	return id;
+}
+
+uint32_t NodeSerializer::BinarySchema::get_field_id(uint32_t p_type_id, const StringName &p_field) {
+	Type &type = types[p_type_id];
+	if (const uint32_t *id = type.field_ids.getptr(p_field)) {
+		return *id;
+	}
+	const uint32_t id = type.fields.size();
+	type.fields.push_back(p_field);
+	type.field_ids.insert(p_field, id);
+	return id;
+}
+
+void NodeSerializer::BinarySchema::write(StateWriter &r_writer) const {
+	r_writer.put_varint(types.size());
+	for (const Type &type : types) {
+		r_writer.put_string(type.name);
+		r_writer.put_varint(type.fields.size());
+		for (const StringName &field : type.fields) {
+			r_writer.put_string(String(field));
+		}
+	}
+}
+
+// Types whose registration is unknown are kept so the error can name them once an object of that type is read.
+Error NodeSerializer::BinarySchema::read(StateReader &p_reader) {
+	const uint64_t type_count = p_reader.get_varint();
+	ERR_FAIL_COND_V(p_reader.has_failed() || type_count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+	types.resize(type_count);
+
+	for (Type &type : types) {
+		type.name = p_reader.get_string();
+		type.registration = _get_serializable_registration(type.name);
+
+		const uint64_t field_count = p_reader.get_varint();
+		ERR_FAIL_COND_V(p_reader.has_failed() || field_count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+		type.fields.resize(field_count);
+		for (StringName &field : type.fields) {
+			field = p_reader.get_string();
+		}
+	}
+
+	return p_reader.has_failed() || !p_reader.is_eof() ? ERR_INVALID_DATA : OK;
+}
+
+// Mirrors _serialize_recursively(), emitting bytes instead of building the structure. Containers are a Variant type
+// tag followed by a varint size, registered objects a Variant::OBJECT tag and an object record, and everything else a
+// tagged StateWriter value.
+void NodeSerializer::_write_value(StateWriter &r_writer, const Variant &p_value, SerializationContext &p_context) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			Array arr = p_value;
+			const int64_t size = arr.size();
+			r_writer.put_u8(Variant::ARRAY);
+			r_writer.put_varint(size);
+			for (int64_t i = 0; i < size; ++i) {
+				_write_value(r_writer, arr[i], p_context);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_value;
+			r_writer.put_u8(Variant::DICTIONARY);
+			r_writer.put_varint(dict.size());
+			for (const auto &key : dict.keys()) {
+				_write_raw_value(r_writer, key);
+				_write_value(r_writer, dict[key], p_context);
+			}
+		} break;
+		case Variant::OBJECT: {
+			Object *obj = p_value.get_validated_object();
+			if (obj) {
+				String reg_name = _get_object_registration_name(obj);
+				ObjectRegistration *registration = _get_serializable_registration(reg_name);
+
+				if (registration) {
+					r_writer.put_u8(Variant::OBJECT);
+					registration->write(r_writer, obj, p_context);
+					break;
+				}
+
+				if (p_context.property_name.is_empty()) {
+					ERR_PRINT("Unregistered Object (" + reg_name + ") cannot be serialized. Register it first.");
+				} else {
+					ERR_PRINT("Unregistered Object (" + reg_name + ") cannot be serialized. Register it first. Property: " + p_context.property_name);
+				}
+			}
+			r_writer.put_value(Variant(), Variant::NIL);
+		} break;
+		default:
+			r_writer.put_value(p_value, Variant::NIL);
+			break;
+	}
+}
+
+// Writes values returned by custom serializers as they are, the way var_to_bytes stores them in the legacy format.
+void NodeSerializer::_write_raw_value(StateWriter &r_writer, const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			Array arr = p_value;
+			const int64_t size = arr.size();
+			r_writer.put_u8(Variant::ARRAY);
+			r_writer.put_varint(size);
+			for (int64_t i = 0; i < size; ++i) {
+				_write_raw_value(r_writer, arr[i]);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_value;
+			r_writer.put_u8(Variant::DICTIONARY);
+			r_writer.put_varint(dict.size());
+			for (const auto &key : dict.keys()) {
+				_write_raw_value(r_writer, key);
+				_write_raw_value(r_writer, dict[key]);
+			}
+		} break;
+		case Variant::OBJECT:
+			r_writer.put_value(Variant(), Variant::NIL);
+			break;
+		default:
+			r_writer.put_value(p_value, Variant::NIL);
+			break;
+	}
+}
+
+// Writes a child count, filled in once known, followed by the same entries _serialize_children() would produce. Each
+// entry is the child name, a BinaryChild kind and either an object record or the nested children.
+uint32_t NodeSerializer::_write_children(StateWriter &r_writer, Node *p_node, SerializationContext &p_context) {
+	const int64_t count_position = r_writer.get_position();
+	r_writer.put_u32(0);
+	uint32_t count = 0;
+
+	for (int i = 0, l = p_node->get_child_count(); i < l; ++i) {
+		Node *child = p_node->get_child(i);
+		const int64_t start = r_writer.get_position();
+		r_writer.put_string(child->get_name());
+
+		String registration_name = _get_object_registration_name(child);
+		ObjectRegistration *registration = _get_serializable_registration(registration_name);
+
+		bool written = false;
+		if (registration) {
+			r_writer.put_u8(BINARY_CHILD_OBJECT);
+			written = registration->write(r_writer, child, p_context);
+		} else {
+			Object *previous_target_object = p_context.target_object;
+			p_context.target_object = child;
+
+			r_writer.put_u8(BINARY_CHILD_UNSERIALIZABLE);
+			written = _write_children(r_writer, child, p_context) > 0;
+
+			p_context.target_object = previous_target_object;
+		}
+
+		if (written) {
+			count++;
+		} else {
+			r_writer.truncate(start);
+		}
+	}
+
+	r_writer.patch_u32(count_position, count);
+	return count;
+}
+
+// Reads an object's type as an index into the payload's schema.
+Error NodeSerializer::_read_type(StateReader &p_reader, const DeserializationContext &p_context, const ObjectRegistration *&r_registration, const BinarySchema::Type *&r_type, String &r_name) {
+	ERR_FAIL_NULL_V(p_context.schema, ERR_UNCONFIGURED);
+	const uint64_t type_id = p_reader.get_varint();
+	ERR_FAIL_COND_V(p_reader.has_failed() || type_id >= p_context.schema->types.size(), ERR_INVALID_DATA);
+	r_type = &p_context.schema->types[type_id];
+	r_name = r_type->name;
+	r_registration = r_type->registration;
+	return OK;
+}
+
+// Reads a value written by _write_value(). Object records are deserialized as they are reached. Raw values keep
+// dictionaries and object records in the structure the legacy format stores, otherwise dictionaries carrying a type
+// field go through _deserialize_recursively() like they do in the legacy format.
+Error NodeSerializer::_read_value(StateReader &p_reader, DeserializationContext &p_context, Variant &r_value, bool p_raw) {
+	const uint8_t tag = p_reader.get_u8();
+	ERR_FAIL_COND_V(p_reader.has_failed() || tag >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+
+	switch (tag) {
+		case Variant::ARRAY: {
+			const uint64_t size = p_reader.get_varint();
+			ERR_FAIL_COND_V(size > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+			Array arr;
+			arr.resize(size);
+			for (uint64_t i = 0; i < size; ++i) {
+				Variant value;
+				const Error err = _read_value(p_reader, p_context, value, p_raw);
+				if (err != OK) {
+					_free_partial_value(arr);
+					ERR_FAIL_V(err);
+				}
+				arr[i] = value;
+			}
+			r_value = arr;
+		} break;
+		case Variant::DICTIONARY: {
+			const uint64_t size = p_reader.get_varint();
+			ERR_FAIL_COND_V(size > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+			Dictionary dict;
+			for (uint64_t i = 0; i < size; ++i) {
+				Variant key;
+				Error err = _read_value(p_reader, p_context, key, true);
+				ERR_FAIL_COND_V(err != OK, err);
+				Variant value;
+				err = _read_value(p_reader, p_context, value, p_raw);
+				if (err != OK) {
+					_free_partial_value(dict);
+					ERR_FAIL_V(err);
+				}
+				dict[key] = value;
+			}
+			r_value = (!p_raw && dict.has(*FIELD_TYPE)) ? _deserialize_recursively(dict, p_context) : Variant(dict);
+		} break;
+		case Variant::OBJECT: {
+			const ObjectRegistration *registration = nullptr;
+			const BinarySchema::Type *type = nullptr;
+			String type_name;
+			Error err = _read_type(p_reader, p_context, registration, type, type_name);
+			ERR_FAIL_COND_V(err != OK, err);
+
+			if (p_raw) {
+				Dictionary serialized;
+				err = _read_object_structure(p_reader, p_context, type_name, type, serialized);
+				ERR_FAIL_COND_V(err != OK, err);
+				r_value = serialized;
+				break;
+			}
+			ERR_FAIL_NULL_V_MSG(registration, ERR_INVALID_DATA, "Attempted to deserialize unregistered type: " + type_name);
+
+			DeserializationContext inner_context = p_context;
+			inner_context.target_object = nullptr;
+			err = registration->read(p_reader, type, inner_context, r_value);
+			ERR_FAIL_COND_V(err != OK, err);
+		} break;
+		case Variant::NIL:
+			// The tag is the whole value; get_value() would read NIL as "type tag follows".
+			r_value = Variant();
+			break;
+		default:
+			r_value = p_reader.get_value(Variant::Type(tag));
+			break;
+	}
+
+	return p_reader.has_failed() ? ERR_INVALID_DATA : OK;
+}
+
+// Frees the objects of a value whose read failed part way: objects nested in arrays and dictionaries, and nodes without
+// a parent along with their children. RefCounted objects are released with the value.
+void NodeSerializer::_free_partial_value(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			const Array arr = p_value;
+			for (int64_t i = 0; i < arr.size(); ++i) {
+				_free_partial_value(arr[i]);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			for (const auto &key : dict.keys()) {
+				_free_partial_value(dict[key]);
+			}
+		} break;
+		case Variant::OBJECT: {
+			Object *object = p_value.get_validated_object();
+			if (!object || Object::cast_to<RefCounted>(object)) {
+				break;
+			}
+			Node *node = Object::cast_to<Node>(object);
+			if (!node || !node->get_parent()) {
+				memdelete(object);
+			}
+		} break;
+		default:
+			break;
+	}
+}
+
+// Applies children written by _write_children() the way _deserialize_children() does. Without a node to apply them to
+// the entries are still consumed, and any node they create is freed.
+Error NodeSerializer::_read_children(StateReader &p_reader, Node *p_node, DeserializationContext &p_context) {
+	const uint32_t count = p_reader.get_u32();
+	ERR_FAIL_COND_V(p_reader.has_failed() || count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		const String child_name = p_reader.get_string();
+		const uint8_t kind = p_reader.get_u8();
+		ERR_FAIL_COND_V(p_reader.has_failed(), ERR_INVALID_DATA);
+
+		Node *child_node = p_node ? p_node->get_node_or_null(NodePath(child_name)) : nullptr;
+
+		if (kind == BINARY_CHILD_UNSERIALIZABLE) {
+			if (p_node && !child_node) {
+				WARN_PRINT("Unable to find expected child during deserialization: " + p_node->get_path().get_concatenated_subnames() + "/" + child_name);
+			}
+			const Error err = _read_children(p_reader, child_node, p_context);
+			ERR_FAIL_COND_V(err != OK, err);
+			continue;
+		}
+		ERR_FAIL_COND_V(kind != BINARY_CHILD_OBJECT, ERR_INVALID_DATA);
+
+		const ObjectRegistration *registration = nullptr;
+		const BinarySchema::Type *type = nullptr;
+		String child_type;
+		Error err = _read_type(p_reader, p_context, registration, type, child_type);
+		ERR_FAIL_COND_V(err != OK, err);
+		ERR_FAIL_NULL_V_MSG(registration, ERR_INVALID_DATA, "Encountered unregistered type: " + child_type + " for child: " + child_name);
+
+		DeserializationContext child_context = p_context;
+		child_context.target_object = nullptr;
+
+		if (child_node) {
+			if (_get_object_registration_name(child_node) == child_type) {
+				child_context.target_object = child_node;
+			} else {
+				p_node->remove_child(child_node);
+				child_node->queue_free();
+			}
+		}
+
+		Variant child;
+		err = registration->read(p_reader, type, child_context, child);
+		ERR_FAIL_COND_V(err != OK, err);
+		Node *new_or_updated_node = Object::cast_to<Node>(child);
+
+		if (!p_node) {
+			if (new_or_updated_node && !new_or_updated_node->get_parent()) {
+				memdelete(new_or_updated_node);
+			}
+		} else if (new_or_updated_node && !new_or_updated_node->get_parent()) {
+			p_node->add_child(new_or_updated_node);
+			new_or_updated_node->set_name(child_name);
+		} else if (new_or_updated_node && new_or_updated_node->get_name() != child_name) {
+			new_or_updated_node->set_name(child_name);
+		}
+	}
+
+	return OK;
+}
+
+// Reads an object record into the dictionary serialize() would have produced for it, without instantiating anything.
+Error NodeSerializer::_read_object_structure(StateReader &p_reader, DeserializationContext &p_context, const String &p_type_name, const BinarySchema::Type *p_type, Dictionary &r_serialized) {
+	if (p_reader.get_u8() != 0) {
+		Variant serialized;
+		const Error err = _read_value(p_reader, p_context, serialized, true);
+		ERR_FAIL_COND_V(err != OK, err);
+		r_serialized = serialized.get_type() == Variant::DICTIONARY ? Dictionary(serialized) : Dictionary();
+		return OK;
+	}
+
+	const String scene_path = p_reader.get_string();
+	ERR_FAIL_COND_V(p_reader.has_failed(), ERR_INVALID_DATA);
+	r_serialized[*FIELD_TYPE] = p_type_name;
+
+	if (!scene_path.is_empty()) {
+		r_serialized[*FIELD_SCENE] = scene_path;
+	}
+
+	return _read_fields_structure(p_reader, p_context, p_type, r_serialized);
+}
+
+// Reads the properties and children of a default object record into r_serialized, keeping nested records as
+// dictionaries the way the legacy format stores them.
+Error NodeSerializer::_read_fields_structure(StateReader &p_reader, DeserializationContext &p_context, const BinarySchema::Type *p_type, Dictionary &r_serialized) {
+	const uint32_t count = p_reader.get_u32();
+	ERR_FAIL_COND_V(p_reader.has_failed() || count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint64_t field_id = p_reader.get_varint();
+		ERR_FAIL_COND_V(p_reader.has_failed() || field_id >= p_type->fields.size(), ERR_INVALID_DATA);
+		const StringName &key = p_type->fields[field_id];
+
+		Variant value;
+		const Error err = _read_value(p_reader, p_context, value, true);
+		ERR_FAIL_COND_V(err != OK, err);
+		r_serialized[key] = value;
+	}
+
+	Dictionary children;
+	const Error err = _read_children_structure(p_reader, p_context, children);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	if (!children.is_empty()) {
+		r_serialized[*FIELD_CHILDREN] = children;
+	}
+	return OK;
+}
+
+// Reads children written by _write_children() into the dictionary _serialize_children() would have produced.
+Error NodeSerializer::_read_children_structure(StateReader &p_reader, DeserializationContext &p_context, Dictionary &r_children) {
+	const uint32_t count = p_reader.get_u32();
+	ERR_FAIL_COND_V(p_reader.has_failed() || count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		const String child_name = p_reader.get_string();
+		const uint8_t kind = p_reader.get_u8();
+		ERR_FAIL_COND_V(p_reader.has_failed(), ERR_INVALID_DATA);
+
+		if (kind == BINARY_CHILD_UNSERIALIZABLE) {
+			Dictionary grandchildren;
+			const Error err = _read_children_structure(p_reader, p_context, grandchildren);
+			ERR_FAIL_COND_V(err != OK, err);
+
+			Dictionary unserializable_child_data;
+			unserializable_child_data[*FIELD_TYPE] = *TYPE_UNSERIALIZABLE_CHILD;
+			unserializable_child_data[*FIELD_CHILDREN] = grandchildren;
+			r_children[child_name] = unserializable_child_data;
+			continue;
+		}
+		ERR_FAIL_COND_V(kind != BINARY_CHILD_OBJECT, ERR_INVALID_DATA);
+
+		const ObjectRegistration *registration = nullptr;
+		const BinarySchema::Type *type = nullptr;
+		String child_type;
+		Error err = _read_type(p_reader, p_context, registration, type, child_type);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		Dictionary child_data;
+		err = _read_object_structure(p_reader, p_context, child_type, type, child_data);
+		ERR_FAIL_COND_V(err != OK, err);
+		r_children[child_name] = child_data;
+	}
+
+	return OK;
+}
+
 Dictionary NodeSerializer::ObjectRegistration::serialize(Object *p_object, SerializationContext &p_context) const {
 	Object *previous_target_object = p_context.target_object;
 	StringName previous_property_name = p_context.property_name;
@@ -504,29 +989,23 @@ Dictionary NodeSerializer::ObjectRegistration::serialize(Object *p_object, Seria
 		}
 	}
 
-	if (unlikely(has_custom_serializer != HasMethod::No)) {
-		if (unlikely(has_custom_serializer == HasMethod::Unchecked)) {
-			has_custom_serializer = p_object->has_method(*METHOD_SERIALIZE) ? HasMethod::Yes : HasMethod::No;
-		}
-
-		if (has_custom_serializer == HasMethod::Yes) {
-			Variant serialized_value = p_object->call(*METHOD_SERIALIZE);
+	if (_uses_custom_serializer(p_object)) {
+		Variant serialized_value = p_object->call(*METHOD_SERIALIZE);
 
-			p_context.target_object = previous_target_object;
-			p_context.property_name = previous_property_name;
-
-			if (serialized_value.get_type() == Variant::DICTIONARY) {
-				Dictionary serialized_dict = serialized_value;
+		p_context.target_object = previous_target_object;
+		p_context.property_name = previous_property_name;
 
-				if (!serialized_dict.has(*FIELD_TYPE)) {
-					serialized_dict[*FIELD_TYPE] = this->name;
-				}
+		if (serialized_value.get_type() == Variant::DICTIONARY) {
+			Dictionary serialized_dict = serialized_value;
 
-				return serialized_dict;
+			if (!serialized_dict.has(*FIELD_TYPE)) {
+				serialized_dict[*FIELD_TYPE] = this->name;
 			}
 
-			return {};
+			return serialized_dict;
 		}
+
+		return {};
 	}
 
 	Dictionary serialized_value = _default_serialize(p_object, p_context);
@@ -537,10 +1016,73 @@ Dictionary NodeSerializer::ObjectRegistration::serialize(Object *p_object, Seria
 	return serialized_value;
 }
 
-const std::map<StringName, NodeSerializer::PropertyCacheData> &NodeSerializer::ObjectRegistration::_build_cached_property_map(Object *p_object) const {
-	_cached_property_map.clear();
+bool NodeSerializer::ObjectRegistration::_uses_custom_serializer(Object *p_object) const {
+	if (likely(has_custom_serializer == HasMethod::No)) {
+		return false;
+	}
+	if (unlikely(has_custom_serializer == HasMethod::Unchecked)) {
+		has_custom_serializer = p_object->has_method(*METHOD_SERIALIZE) ? HasMethod::Yes : HasMethod::No;
+	}
+	return has_custom_serializer == HasMethod::Yes;
+}
+
+// Object record: the schema type ID and a flag for custom serializers, followed by the raw dictionary _serialize()
+// returned, or the scene path, a counted list of field ID and value pairs and the node's children.
+bool NodeSerializer::ObjectRegistration::write(StateWriter &r_writer, Object *p_object, SerializationContext &p_context) const {
+	ERR_FAIL_NULL_V(p_context.schema, false);
+	const uint32_t type_id = p_context.schema->get_type_id(this);
+	r_writer.put_varint(type_id);
+
+	Object *previous_target_object = p_context.target_object;
+	StringName previous_property_name = p_context.property_name;
+
+	p_context.target_object = p_object;
+	p_context.property_name = StringName();
+
+	Node *node = Object::cast_to<Node>(p_object);
+
+	if (node) {
+		String scene_path = node->get_scene_file_path();
+
+		if (!scene_path.is_empty()) {
+			p_context.scene_root_node = node;
+		}
+	}
+
+	bool written = true;
+
+	if (_uses_custom_serializer(p_object)) {
+		Variant serialized_value = p_object->call(*METHOD_SERIALIZE);
+		r_writer.put_u8(1);
+
+		if (serialized_value.get_type() == Variant::DICTIONARY) {
+			Dictionary serialized_dict = serialized_value;
+
+			if (!serialized_dict.has(*FIELD_TYPE)) {
+				serialized_dict[*FIELD_TYPE] = this->name;
+			}
+
+			_write_raw_value(r_writer, serialized_dict);
+		} else {
+			_write_raw_value(r_writer, Dictionary());
+			written = false;
+		}
+	} else {
+		r_writer.put_u8(0);
+		_default_write(r_writer, type_id, p_object, p_context);
+	}
+
+	p_context.target_object = previous_target_object;
+	p_context.property_name = previous_property_name;
+
+	return written;
+}
+
+void NodeSerializer::ObjectRegistration::_compile_plan(Object *p_object, SerializationPlan &r_plan) {
+	r_plan.clear();
 	StringName class_name = p_object->get_class();
 	Array property_list = p_object->get_property_list();
+	r_plan.properties.reserve(property_list.size());
 
 	for (int64_t i = 0, count = property_list.size(); i < count; ++i) {
 		Dictionary property_info = property_list[i];
@@ -556,7 +1098,7 @@ const std::map<StringName, NodeSerializer::PropertyCacheData> &NodeSerializer::O
 		StringName custom_deserializer_method = "_deserialize_property_" + property_name;
 		bool has_custom_deserializer = p_object->has_method(custom_deserializer_method);
 
-		_cached_property_map[property_name] = {
+		PropertyCacheData data = {
 			.type = Variant::Type(int(property_info["type"])),
 			.name = property_name,
 			.usage = property_info["usage"],
@@ -566,17 +1108,148 @@ const std::map<StringName, NodeSerializer::PropertyCacheData> &NodeSerializer::O
 			.custom_deserializer_name = has_custom_deserializer ? custom_deserializer_method : StringName(),
 			.has_custom_deserializer = has_custom_deserializer,
 		};
+
+		// A repeated name replaces the earlier entry, the way a keyed lookup would.
+		if (const uint32_t *slot = r_plan.slots.getptr(property_name)) {
+			r_plan.properties[*slot] = data;
+		} else {
+			r_plan.slots.insert(property_name, r_plan.properties.size());
+			r_plan.properties.push_back(data);
+		}
 	}
-	return _cached_property_map;
+}
+
+const LocalVector<uint32_t> &NodeSerializer::SerializationPlan::get_slots(int p_required_usage_flags) const {
+	if (filtered_usage != p_required_usage_flags) {
+		filtered_slots.clear();
+		for (uint32_t i = 0; i < properties.size(); ++i) {
+			if (properties[i].usage & p_required_usage_flags) {
+				filtered_slots.push_back(i);
+			}
+		}
+		filtered_usage = p_required_usage_flags;
+	}
+	return filtered_slots;
+}
+
+void NodeSerializer::SerializationPlan::clear() {
+	properties.clear();
+	slots.clear();
+	filtered_slots.clear();
+	filtered_usage = -1;
 }
 
 Object *NodeSerializer::ObjectRegistration::deserialize(const Dictionary &p_serialized, DeserializationContext &p_context) const {
+	Object *object = _instantiate(p_serialized.get(*FIELD_SCENE, ""), p_context);
+
+	if (!object) {
+		return nullptr;
+	}
+
+	if (object->has_method("_deserialize")) {
+		object->call("_deserialize", p_serialized);
+		return object;
+	}
+
+	return _default_deserialize(p_serialized, p_context);
+}
+
+// Reads an object record written by write(). Objects with a _deserialize() method receive the same dictionary as in
+// the legacy format, with nested objects and children left serialized for them to handle.
+Error NodeSerializer::ObjectRegistration::read(StateReader &p_reader, const BinarySchema::Type *p_type, DeserializationContext &p_context, Variant &r_value) const {
+	if (p_reader.get_u8() != 0) {
+		Variant serialized;
+		const Error err = _read_value(p_reader, p_context, serialized, true);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		if (serialized.get_type() == Variant::DICTIONARY && Dictionary(serialized).has(*FIELD_TYPE)) {
+			r_value = deserialize(serialized, p_context);
+		} else {
+			r_value = serialized;
+		}
+		return OK;
+	}
+
+	const String scene_path = p_reader.get_string();
+	ERR_FAIL_COND_V(p_reader.has_failed(), ERR_INVALID_DATA);
+	Object *object = _instantiate(scene_path, p_context);
+	ERR_FAIL_NULL_V(object, ERR_CANT_CREATE);
+	r_value = object;
+
+	const Error err = _read_object(p_reader, p_type, p_context, object, scene_path);
+	if (err != OK && object != p_context.target_object) {
+		// Nothing else refers to an object created for a record that failed to read, nor to the children it gained.
+		const Variant partial = r_value;
+		r_value = Variant();
+		_free_partial_value(partial);
+	}
+	return err;
+}
+
+Error NodeSerializer::ObjectRegistration::_read_object(StateReader &p_reader, const BinarySchema::Type *p_type, DeserializationContext &p_context, Object *p_object, const String &p_scene_path) const {
+	Object *object = p_object;
+	if (object->has_method("_deserialize")) {
+		Dictionary serialized;
+		serialized[*FIELD_TYPE] = this->name;
+
+		if (!p_scene_path.is_empty()) {
+			serialized[*FIELD_SCENE] = p_scene_path;
+		}
+
+		const Error err = _read_fields_structure(p_reader, p_context, p_type, serialized);
+		ERR_FAIL_COND_V(err != OK, err);
+		object->call("_deserialize", serialized);
+		return OK;
+	}
+
+	SerializationPlan local_plan;
+	const SerializationPlan &plan = _get_plan(object, local_plan);
+	// Field IDs map straight to plan slots, unless the plan is recompiled per object.
+	const bool use_field_slots = !mutable_property_list;
+	if (use_field_slots && p_type->field_slots.size() != p_type->fields.size()) {
+		p_type->field_slots.resize(p_type->fields.size());
+		for (uint32_t i = 0; i < p_type->fields.size(); ++i) {
+			const uint32_t *slot = plan.slots.getptr(p_type->fields[i]);
+			p_type->field_slots[i] = slot ? int32_t(*slot) : -1;
+		}
+	}
+
+	const uint32_t count = p_reader.get_u32();
+	ERR_FAIL_COND_V(p_reader.has_failed() || count > uint64_t(p_reader.get_available()), ERR_INVALID_DATA);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint64_t field_id = p_reader.get_varint();
+		ERR_FAIL_COND_V(p_reader.has_failed() || field_id >= p_type->fields.size(), ERR_INVALID_DATA);
+		const StringName &key = p_type->fields[field_id];
+		const PropertyCacheData *prop_info = nullptr;
+		if (use_field_slots) {
+			const int32_t slot = p_type->field_slots[field_id];
+			prop_info = slot >= 0 ? &plan.properties[slot] : nullptr;
+		} else {
+			prop_info = plan.find(key);
+		}
+		const bool raw = prop_info && prop_info->has_custom_deserializer;
+
+		Variant value;
+		const Error err = _read_value(p_reader, p_context, value, raw);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		if (raw) {
+			object->call(prop_info->custom_deserializer_name, value);
+		} else {
+			_set_property(object, key, value, prop_info, p_context);
+		}
+	}
+
+	return _read_children(p_reader, Object::cast_to<Node>(object), p_context);
+}
+
+Object *NodeSerializer::ObjectRegistration::_instantiate(const String &p_scene_path, DeserializationContext &p_context) const {
 	Object *object = p_context.target_object;
 
 	if (!object) {
-		String scene_path = p_serialized.get(*FIELD_SCENE, "");
-		if (!scene_path.is_empty()) {
-			Ref<PackedScene> packed_scene = ResourceLoader::get_singleton()->load(scene_path);
+		if (!p_scene_path.is_empty()) {
+			Ref<PackedScene> packed_scene = ResourceLoader::get_singleton()->load(p_scene_path);
 			if (packed_scene.is_valid()) {
 				object = packed_scene->instantiate();
 			}
@@ -603,22 +1276,19 @@ Object *NodeSerializer::ObjectRegistration::deserialize(const Dictionary &p_seri
 		}
 	}
 
-	if (object->has_method("_deserialize")) {
-		object->call("_deserialize", p_serialized);
-		return object;
-	}
-
-	return _default_deserialize(p_serialized, p_context);
+	return object;
 }
 
 Dictionary NodeSerializer::ObjectRegistration::_default_serialize(Object *p_object, SerializationContext &p_context) const {
 	Dictionary result;
 	int required_property_usage_flags = p_context.required_property_usage_flags;
 
-	for (const auto &[property_name, property_info] : _get_property_map(p_object)) {
-		if (!(property_info.usage & required_property_usage_flags)) {
-			continue;
-		}
+	SerializationPlan local_plan;
+	const SerializationPlan &plan = _get_plan(p_object, local_plan);
+
+	for (uint32_t slot : plan.get_slots(required_property_usage_flags)) {
+		const PropertyCacheData &property_info = plan.properties[slot];
+		const StringName &property_name = property_info.name;
 
 		if (property_info.has_custom_serializer) {
 			result[property_name] = p_object->call(property_info.custom_serializer_name);
@@ -668,10 +1338,96 @@ Dictionary NodeSerializer::ObjectRegistration::_default_serialize(Object *p_obje
 	return result;
 }
 
+void NodeSerializer::ObjectRegistration::_default_write(StateWriter &r_writer, uint32_t p_type_id, Object *p_object, SerializationContext &p_context) const {
+	int required_property_usage_flags = p_context.required_property_usage_flags;
+	Node *node = Object::cast_to<Node>(p_object);
+	String scene_path = node ? node->get_scene_file_path() : String();
+	r_writer.put_string(scene_path.begins_with("res://") ? scene_path : String());
+
+	const int64_t count_position = r_writer.get_position();
+	r_writer.put_u32(0);
+	uint32_t count = 0;
+
+	SerializationPlan local_plan;
+	const SerializationPlan &plan = _get_plan(p_object, local_plan);
+
+	for (uint32_t slot : plan.get_slots(required_property_usage_flags)) {
+		const PropertyCacheData &property_info = plan.properties[slot];
+		const StringName &property_name = property_info.name;
+
+		if (property_info.has_custom_serializer) {
+			r_writer.put_varint(p_context.schema->get_field_id(p_type_id, property_name));
+			_write_raw_value(r_writer, p_object->call(property_info.custom_serializer_name));
+			count++;
+			continue;
+		}
+
+		Variant value = p_object->get(property_name);
+
+		if (value == property_info.default_value) {
+			continue;
+		}
+
+		if (value.get_type() == Variant::OBJECT) {
+			Node *value_as_node = Object::cast_to<Node>(value);
+
+			if (value_as_node) {
+				if (p_context.scene_root_node) {
+					r_writer.put_varint(p_context.schema->get_field_id(p_type_id, property_name));
+					r_writer.put_value(p_context.scene_root_node->get_path_to(value_as_node), Variant::NIL);
+					count++;
+				}
+
+				continue;
+			}
+		}
+
+		StringName previous_property_name = p_context.property_name;
+		p_context.property_name = property_name;
+		r_writer.put_varint(p_context.schema->get_field_id(p_type_id, property_name));
+		_write_value(r_writer, value, p_context);
+		p_context.property_name = previous_property_name;
+		count++;
+	}
+
+	r_writer.patch_u32(count_position, count);
+
+	if (node) {
+		_write_children(r_writer, node, p_context);
+	} else {
+		r_writer.put_u32(0);
+	}
+}
+
+void NodeSerializer::ObjectRegistration::_set_property(Object *p_object, const StringName &p_key, const Variant &p_value, const PropertyCacheData *p_info, DeserializationContext &p_context) const {
+	if (p_value.get_type() == Variant::NODE_PATH && p_info && p_info->type == Variant::OBJECT) {
+		String path = p_value;
+		Node *scene_root_node = p_context.scene_root_node;
+
+		if (!scene_root_node) {
+			ERR_PRINT("Unable to deserialize object node path property without scene root node: " + name + "/" + String(p_key));
+			return;
+		}
+
+		auto node = scene_root_node->get_node_or_null(path);
+
+		if (!node) {
+			ERR_PRINT("Failed to resolve object for node path property " + name + ":" + String(p_key) + ": " + path);
+			return;
+		}
+
+		p_object->set(p_key, node);
+	} else {
+		p_object->set(p_key, p_value);
+	}
+}
+
 Object *NodeSerializer::ObjectRegistration::_default_deserialize(const Dictionary &p_serialized, DeserializationContext &p_context) const {
 	Object *object = p_context.target_object;
 	ERR_FAIL_COND_V(!object, nullptr);
 
+	SerializationPlan local_plan;
+	const SerializationPlan &plan = _get_plan(object, local_plan);
 	Array keys = p_serialized.keys();
 	for (int i = 0; i < keys.size(); ++i) {
 		StringName key = keys[i];
@@ -681,36 +1437,15 @@ Object *NodeSerializer::ObjectRegistration::_default_deserialize(const Dictionar
 
 		Variant value = p_serialized[key];
 
-		const auto &property_list = _get_property_map(object);
-		auto prop_info_it = property_list.find(key);
+		const PropertyCacheData *prop_info = plan.find(key);
 
-		if (prop_info_it != property_list.end() && prop_info_it->second.has_custom_deserializer) {
-			object->call(prop_info_it->second.custom_deserializer_name, value);
+		if (prop_info && prop_info->has_custom_deserializer) {
+			object->call(prop_info->custom_deserializer_name, value);
 			continue;
 		}
 
 		Variant deserialized_value = p_context.deserialize_value(value, p_context);
-
-		if (deserialized_value.get_type() == Variant::NODE_PATH && prop_info_it != property_list.end() && prop_info_it->second.type == Variant::OBJECT) {
-			String path = deserialized_value;
-			Node *scene_root_node = p_context.scene_root_node;
-
-			if (!scene_root_node) {
-				ERR_PRINT("Unable to deserialize object node path property without scene root node: " + name + "/" + key);
-				continue;
-			}
-
-			auto node = scene_root_node->get_node_or_null(path);
-
-			if (!node) {
-				ERR_PRINT("Failed to resolve object for node path property " + name + ":" + key + ": " + path);
-				continue;
-			}
-
-			object->set(key, node);
-		} else {
-			object->set(key, deserialized_value);
-		}
+		_set_property(object, key, deserialized_value, prop_info, p_context);
 	}
 
 	if (Node *node = Object::cast_to<Node>(object)) {
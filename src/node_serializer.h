@@ -1,5 +1,7 @@
 #pragma once
 
+#include "state_codec.h"
+
 #include "godot_cpp/classes/script.hpp"
 #include <functional>
 #include <godot_cpp/classes/node.hpp>
@@ -7,11 +9,11 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/string_name.hpp>
 #include <godot_cpp/variant/variant.hpp>
-#include <map>
 
 using namespace godot;
 
@@ -37,18 +39,44 @@ public:
 private:
 	NodeSerializer() = default;
 
+	class ObjectRegistration;
+
+	// Registration and property names of a binary payload, interned as they are first written and stored once in the
+	// payload's schema table. Objects refer to their type by index and to their properties by index into its fields.
+	struct BinarySchema {
+		struct Type {
+			String name;
+			const ObjectRegistration *registration = nullptr;
+			LocalVector<StringName> fields;
+			HashMap<StringName, uint32_t> field_ids;
+			// Plan slot of each field when reading, -1 for fields the registration does not have. Resolved on the
+			// first object of the type.
+			mutable LocalVector<int32_t> field_slots;
+		};
+
+		LocalVector<Type> types;
+		HashMap<const ObjectRegistration *, uint32_t> type_ids;
+
+		uint32_t get_type_id(const ObjectRegistration *p_registration);
+		uint32_t get_field_id(uint32_t p_type_id, const StringName &p_field);
+		void write(StateWriter &r_writer) const;
+		Error read(StateReader &p_reader);
+	};
+
 	struct SerializationContext {
 		std::function<Variant(const Variant &, SerializationContext &)> serialize_value;
 		Object *target_object = nullptr;
 		Node *scene_root_node = nullptr;
 		int required_property_usage_flags = PROPERTY_USAGE_STORAGE;
 		StringName property_name = StringName();
+		BinarySchema *schema = nullptr;
 	};
 
 	struct DeserializationContext {
 		std::function<Variant(const Variant &, DeserializationContext &)> deserialize_value;
 		Object *target_object = nullptr;
 		Node *scene_root_node = nullptr;
+		const BinarySchema *schema = nullptr;
 	};
 
 	struct PropertyCacheData {
@@ -62,6 +90,24 @@ private:
 		bool has_custom_deserializer = false;
 	};
 
+	// Flat compilation of a registration's property list, in property list order. Custom property serializer and
+	// deserializer methods are resolved when it is compiled.
+	struct SerializationPlan {
+		LocalVector<PropertyCacheData> properties;
+		HashMap<StringName, uint32_t> slots;
+		// Slots of the properties matching filtered_usage, rebuilt when an object is serialized with other flags.
+		mutable LocalVector<uint32_t> filtered_slots;
+		mutable int64_t filtered_usage = -1;
+
+		_ALWAYS_INLINE_ const PropertyCacheData *find(const StringName &p_name) const {
+			const uint32_t *slot = slots.getptr(p_name);
+			return slot ? &properties[*slot] : nullptr;
+		}
+
+		const LocalVector<uint32_t> &get_slots(int p_required_usage_flags) const;
+		void clear();
+	};
+
 	class ObjectRegistration {
 	private:
 		enum class HasMethod : uint8_t {
@@ -78,20 +124,37 @@ private:
 		Dictionary serialize(Object *p_object, SerializationContext &p_context) const;
 		Object *deserialize(const Dictionary &p_serialized, DeserializationContext &p_context) const;
 
+		// Streaming counterparts of serialize() and deserialize(), reading and writing an object record directly. write()
+		// returns false if the object produced nothing worth keeping.
+		bool write(StateWriter &r_writer, Object *p_object, SerializationContext &p_context) const;
+		Error read(StateReader &p_reader, const BinarySchema::Type *p_type, DeserializationContext &p_context, Variant &r_value) const;
+
 	private:
-		mutable std::map<StringName, PropertyCacheData> _cached_property_map;
+		mutable SerializationPlan _plan;
+		mutable bool _plan_compiled = false;
 		mutable HasMethod has_custom_serializer = HasMethod::Unchecked;
 
-		_ALWAYS_INLINE_ const std::map<StringName, PropertyCacheData> &_get_property_map(Object *p_object) const {
-			if (!mutable_property_list && !_cached_property_map.empty()) {
-				return _cached_property_map;
+		// Only immutable registrations share _plan. A mutable one is compiled into r_local for each object, since a
+		// nested object of the same registration would otherwise recompile the plan its parent is still iterating.
+		_ALWAYS_INLINE_ const SerializationPlan &_get_plan(Object *p_object, SerializationPlan &r_local) const {
+			if (mutable_property_list) {
+				_compile_plan(p_object, r_local);
+				return r_local;
 			}
-
-			return _build_cached_property_map(p_object);
+			if (!_plan_compiled) {
+				_compile_plan(p_object, _plan);
+				_plan_compiled = true;
+			}
+			return _plan;
 		}
 
-		const std::map<StringName, PropertyCacheData> &_build_cached_property_map(Object *p_object) const;
+		static void _compile_plan(Object *p_object, SerializationPlan &r_plan);
+		bool _uses_custom_serializer(Object *p_object) const;
+		Object *_instantiate(const String &p_scene_path, DeserializationContext &p_context) const;
+		Error _read_object(StateReader &p_reader, const BinarySchema::Type *p_type, DeserializationContext &p_context, Object *p_object, const String &p_scene_path) const;
+		void _set_property(Object *p_object, const StringName &p_key, const Variant &p_value, const PropertyCacheData *p_info, DeserializationContext &p_context) const;
 		Dictionary _default_serialize(Object *p_object, SerializationContext &p_context) const;
+		void _default_write(StateWriter &r_writer, uint32_t p_type_id, Object *p_object, SerializationContext &p_context) const;
 		Object *_default_deserialize(const Dictionary &p_serialized, DeserializationContext &p_context) const;
 	};
 
@@ -115,6 +178,16 @@ private:
 	static StringName *REQUIRED_PROPERTY_USAGE_FLAGS;
 	static StringName *SCENE_ROOT_NODE;
 
+	// Binary payloads written by serialize_to_binary start with this magic ("NSB") and a version byte. Anything else is
+	// read as a legacy var_to_bytes structure.
+	static constexpr uint32_t BINARY_MAGIC = 0x42534E;
+	static constexpr uint8_t BINARY_VERSION = 1;
+
+	enum BinaryChild : uint8_t {
+		BINARY_CHILD_OBJECT,
+		BINARY_CHILD_UNSERIALIZABLE,
+	};
+
 	static HashSet<String> _class_db_classes;
 	static HashMap<String, ObjectRegistration *> _object_registry;
 
@@ -148,6 +221,17 @@ private:
 	static Dictionary _serialize_children(Node *p_node, SerializationContext &p_context);
 	static void _deserialize_children(Node *node, const Dictionary &p_serialized_children, DeserializationContext &p_context);
 
+	static void _write_value(StateWriter &r_writer, const Variant &p_value, SerializationContext &p_context);
+	static void _write_raw_value(StateWriter &r_writer, const Variant &p_value);
+	static uint32_t _write_children(StateWriter &r_writer, Node *p_node, SerializationContext &p_context);
+	static Error _read_value(StateReader &p_reader, DeserializationContext &p_context, Variant &r_value, bool p_raw = false);
+	static Error _read_type(StateReader &p_reader, const DeserializationContext &p_context, const ObjectRegistration *&r_registration, const BinarySchema::Type *&r_type, String &r_name);
+	static Error _read_children(StateReader &p_reader, Node *p_node, DeserializationContext &p_context);
+	static void _free_partial_value(const Variant &p_value);
+	static Error _read_object_structure(StateReader &p_reader, DeserializationContext &p_context, const String &p_type_name, const BinarySchema::Type *p_type, Dictionary &r_serialized);
+	static Error _read_fields_structure(StateReader &p_reader, DeserializationContext &p_context, const BinarySchema::Type *p_type, Dictionary &r_serialized);
+	static Error _read_children_structure(StateReader &p_reader, DeserializationContext &p_context, Dictionary &r_children);
+
 protected:
 	static void _bind_methods();
 };
@@ -0,0 +1,132 @@
+#include "packet_aggregator.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+void PacketAggregator::set_mtu(int64_t p_mtu) {
+	ERR_FAIL_COND_MSG(p_mtu < MIN_MTU, vformat("The packet MTU must be at least %d bytes.", MIN_MTU));
+	mtu = p_mtu;
+}
+
+void PacketAggregator::_flush(Batch &r_batch) {
+	if (r_batch.writer.get_position() > 0) {
+		r_batch.packets.push_back(r_batch.writer.finish());
+	}
+}
+
+void PacketAggregator::add_entry(Batch &r_batch, uint32_t p_net_id, const uint8_t *p_data, int64_t p_size) {
+	fragment_writer.clear();
+	fragment_writer.put_varint(p_net_id);
+	fragment_writer.put_varint(p_size);
+	const int64_t entry_size = fragment_writer.get_position() + p_size;
+
+	if (ENTRIES_HEADER_SIZE + entry_size > mtu) {
+		fragment_writer.put_bytes(p_data, p_size);
+		_add_fragments(r_batch, fragment_writer.get_data(), fragment_writer.get_position());
+		return;
+	}
+
+	if (r_batch.writer.get_position() + entry_size > mtu) {
+		_flush(r_batch);
+	}
+	if (r_batch.writer.get_position() == 0) {
+		r_batch.writer.put_u8(PACKET_ENTRIES);
+	}
+	r_batch.writer.put_bytes(fragment_writer.get_data(), fragment_writer.get_position());
+	r_batch.writer.put_bytes(p_data, p_size);
+}
+
+void PacketAggregator::_add_fragments(Batch &r_batch, const uint8_t *p_data, int64_t p_size) {
+	const int64_t chunk = mtu - FRAGMENT_HEADER_SIZE;
+	const int64_t count = (p_size + chunk - 1) / chunk;
+	ERR_FAIL_COND_MSG(count > MAX_FRAGMENTS, vformat("State of %d bytes needs more than %d fragments at an MTU of %d.", p_size, MAX_FRAGMENTS, mtu));
+
+	const uint16_t group = next_group++;
+	for (int64_t i = 0; i < count; i++) {
+		const int64_t offset = i * chunk;
+		const int64_t size = MIN(chunk, p_size - offset);
+		StateWriter writer;
+		writer.put_u8(PACKET_FRAGMENT);
+		writer.put_u16(group);
+		writer.put_u8(i);
+		writer.put_u8(count);
+		writer.put_bytes(p_data + offset, size);
+		r_batch.packets.push_back(writer.finish());
+	}
+}
+
+TypedArray<PackedByteArray> PacketAggregator::finish(Batch &r_batch) {
+	_flush(r_batch);
+	TypedArray<PackedByteArray> result;
+	result.resize(r_batch.packets.size());
+	for (uint32_t i = 0; i < r_batch.packets.size(); i++) {
+		result[i] = r_batch.packets[i];
+	}
+	r_batch.packets.clear();
+	return result;
+}
+
+PackedByteArray PacketAggregator::receive(int32_t p_peer_id, const PackedByteArray &p_packet) {
+	StateReader reader(p_packet);
+	const uint8_t type = reader.get_u8();
+	ERR_FAIL_COND_V(reader.has_failed(), PackedByteArray());
+
+	if (type == PACKET_ENTRIES) {
+		return p_packet.slice(ENTRIES_HEADER_SIZE);
+	}
+	ERR_FAIL_COND_V_MSG(type != PACKET_FRAGMENT, PackedByteArray(), vformat("Unknown packet type %d.", type));
+	return _receive_fragment(p_peer_id, reader);
+}
+
+PackedByteArray PacketAggregator::_receive_fragment(int32_t p_peer_id, StateReader &p_reader) {
+	const uint16_t group = p_reader.get_u16();
+	const uint8_t index = p_reader.get_u8();
+	const uint8_t count = p_reader.get_u8();
+	ERR_FAIL_COND_V(p_reader.has_failed() || count == 0 || index >= count, PackedByteArray());
+	const int64_t size = p_reader.get_available();
+	const uint8_t *data = p_reader.get_bytes(size);
+
+	LocalVector<Assembly> &peer_assemblies = assemblies[p_peer_id];
+	Assembly *assembly = nullptr;
+	for (Assembly &E : peer_assemblies) {
+		if (E.group == group) {
+			assembly = &E;
+			break;
+		}
+	}
+	if (!assembly) {
+		if (peer_assemblies.size() >= MAX_ASSEMBLIES) {
+			// Fragments were lost; the oldest group can no longer complete.
+			peer_assemblies.remove_at(0);
+		}
+		peer_assemblies.push_back(Assembly());
+		assembly = &peer_assemblies[peer_assemblies.size() - 1];
+		assembly->group = group;
+		assembly->parts.resize(count);
+	}
+	ERR_FAIL_COND_V_MSG(assembly->parts.size() != count, PackedByteArray(), "Fragment count mismatch.");
+
+	PackedByteArray &part = assembly->parts[index];
+	if (part.is_empty()) {
+		part.resize(size);
+		memcpy(part.ptrw(), data, size);
+		assembly->received++;
+	}
+	if (assembly->received < count) {
+		return PackedByteArray();
+	}
+
+	StateWriter writer;
+	for (const PackedByteArray &E : assembly->parts) {
+		writer.put_bytes(E.ptr(), E.size());
+	}
+	peer_assemblies.remove_at(assembly - peer_assemblies.ptr());
+	return writer.finish();
+}
+
+void PacketAggregator::remove_peer(int32_t p_peer_id) {
+	assemblies.erase(p_peer_id);
+}
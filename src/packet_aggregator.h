@@ -0,0 +1,63 @@
+#pragma once
+
+#include "state_codec.h"
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+namespace godot {
+
+// Packs the entries of a packed batch (varint net_id, varint payload size, payload) into packets no larger than the
+// MTU. Each packet starts with a one byte type: PACKET_ENTRIES is followed by whole entries, PACKET_FRAGMENT carries a
+// slice of a single entry too large to fit on its own, as u16 group, u8 index, u8 count, then the slice. Receivers
+// reassemble fragments per peer and get back ordinary batches.
+class PacketAggregator {
+public:
+	enum PacketType : uint8_t {
+		PACKET_ENTRIES,
+		PACKET_FRAGMENT,
+	};
+
+	static constexpr int64_t ENTRIES_HEADER_SIZE = 1;
+	static constexpr int64_t FRAGMENT_HEADER_SIZE = 5;
+	static constexpr int64_t MIN_MTU = 64;
+	static constexpr uint32_t MAX_FRAGMENTS = 255;
+	// Incomplete groups kept per peer; the oldest is dropped when another one starts.
+	static constexpr uint32_t MAX_ASSEMBLIES = 8;
+
+	struct Batch {
+		StateWriter writer;
+		LocalVector<PackedByteArray> packets;
+	};
+
+private:
+	struct Assembly {
+		uint16_t group = 0;
+		uint32_t received = 0;
+		LocalVector<PackedByteArray> parts;
+	};
+
+	int64_t mtu = 1200;
+	uint16_t next_group = 0;
+	StateWriter fragment_writer;
+	HashMap<int32_t, LocalVector<Assembly>> assemblies;
+
+	void _flush(Batch &r_batch);
+	void _add_fragments(Batch &r_batch, const uint8_t *p_data, int64_t p_size);
+	PackedByteArray _receive_fragment(int32_t p_peer_id, StateReader &p_reader);
+
+public:
+	void set_mtu(int64_t p_mtu);
+	int64_t get_mtu() const { return mtu; }
+
+	void add_entry(Batch &r_batch, uint32_t p_net_id, const uint8_t *p_data, int64_t p_size);
+	TypedArray<PackedByteArray> finish(Batch &r_batch);
+
+	PackedByteArray receive(int32_t p_peer_id, const PackedByteArray &p_packet);
+	void remove_peer(int32_t p_peer_id);
+};
+
+} //namespace godot
@@ -0,0 +1,57 @@
+#include "priority_scheduler.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+
+using namespace godot;
+
+void PriorityScheduler::add_slot() {
+	slot_count++;
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		Peer &peer = E.value;
+		peer.sync_priority.push_back(0);
+		peer.delta_priority.push_back(0);
+		peer.last_sync_usec.push_back(0);
+		peer.last_delta_usec.push_back(0);
+	}
+}
+
+void PriorityScheduler::remove_slot(uint32_t p_index) {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, slot_count);
+	const uint32_t last = --slot_count;
+	for (KeyValue<int32_t, Peer> &E : peers) {
+		Peer &peer = E.value;
+		if (p_index != last) {
+			peer.sync_priority[p_index] = peer.sync_priority[last];
+			peer.delta_priority[p_index] = peer.delta_priority[last];
+			peer.last_sync_usec[p_index] = peer.last_sync_usec[last];
+			peer.last_delta_usec[p_index] = peer.last_delta_usec[last];
+		}
+		peer.sync_priority.resize(last);
+		peer.delta_priority.resize(last);
+		peer.last_sync_usec.resize(last);
+		peer.last_delta_usec.resize(last);
+	}
+}
+
+void PriorityScheduler::set_peer_budget(int32_t p_peer_id, int64_t p_budget) {
+	ERR_FAIL_COND_MSG(p_budget <= 0, "Peer bandwidth budget must be greater than 0.");
+	Peer *peer = peers.getptr(p_peer_id);
+	if (!peer) {
+		peer = &peers[p_peer_id];
+		peer->sync_priority.resize(slot_count);
+		peer->delta_priority.resize(slot_count);
+		peer->last_sync_usec.resize(slot_count);
+		peer->last_delta_usec.resize(slot_count);
+		for (uint32_t i = 0; i < slot_count; i++) {
+			peer->sync_priority[i] = 0;
+			peer->delta_priority[i] = 0;
+			peer->last_sync_usec[i] = 0;
+			peer->last_delta_usec[i] = 0;
+		}
+	}
+	peer->budget = p_budget;
+}
+
+void PriorityScheduler::remove_peer(int32_t p_peer_id) {
+	peers.erase(p_peer_id);
+}
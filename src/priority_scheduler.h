@@ -0,0 +1,45 @@
+#pragma once
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+namespace godot {
+
+// Per-peer outbound scheduling state for budgeted replication. Every due synchronizer accumulates its priority each
+// gather it is starved, and is reset once its state makes it into the peer's byte budget. Send times are tracked per
+// peer so a deferred state is retried on the next gather and deltas cover everything since that peer's last send.
+// Slots mirror SceneSynchronizerServer's arrays.
+class PriorityScheduler {
+public:
+	struct Peer {
+		int64_t budget = 0;
+		LocalVector<float> sync_priority;
+		LocalVector<float> delta_priority;
+		LocalVector<uint64_t> last_sync_usec;
+		LocalVector<uint64_t> last_delta_usec;
+	};
+
+	struct Candidate {
+		float priority = 0;
+		uint32_t index = 0;
+
+		// Highest priority first.
+		bool operator<(const Candidate &p_other) const { return priority > p_other.priority; }
+	};
+
+private:
+	uint32_t slot_count = 0;
+	HashMap<int32_t, Peer> peers;
+
+public:
+	void add_slot();
+	void remove_slot(uint32_t p_index);
+
+	void set_peer_budget(int32_t p_peer_id, int64_t p_budget);
+	void remove_peer(int32_t p_peer_id);
+	Peer *get_peer(int32_t p_peer_id) { return peers.getptr(p_peer_id); }
+	const Peer *get_peer(int32_t p_peer_id) const { return peers.getptr(p_peer_id); }
+	HashMap<int32_t, Peer> &get_peers() { return peers; }
+};
+
+} //namespace godot
@@ -2,15 +2,20 @@
 
 #include <gdextension_interface.h>
 
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 
 #include "node_serializer.h"
+#include "replication_plan.h"
 #include "scene_synchronizer.h"
+#include "scene_synchronizer_server.h"
 
 using namespace godot;
 
+static SceneSynchronizerServer *scene_synchronizer_server = nullptr;
+
 void initialize_scene_synchronizer_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
@@ -20,6 +25,10 @@ void initialize_scene_synchronizer_module(ModuleInitializationLevel p_level) {
 
 	GDREGISTER_CLASS(NodeSerializer);
 	GDREGISTER_CLASS(SceneSynchronizer);
+	GDREGISTER_CLASS(SceneSynchronizerServer);
+
+	scene_synchronizer_server = memnew(SceneSynchronizerServer);
+	Engine::get_singleton()->register_singleton("SceneSynchronizerServer", scene_synchronizer_server);
 }
 
 void uninitialize_scene_synchronizer_module(ModuleInitializationLevel p_level) {
@@ -27,7 +36,12 @@ void uninitialize_scene_synchronizer_module(ModuleInitializationLevel p_level) {
 		return;
 	}
 
+	Engine::get_singleton()->unregister_singleton("SceneSynchronizerServer");
+	memdelete(scene_synchronizer_server);
+	scene_synchronizer_server = nullptr;
+
 	NodeSerializer::cleanup();
+	ReplicationPlan::cleanup();
 }
 
 extern "C" {
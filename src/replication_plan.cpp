@@ -0,0 +1,102 @@
+#include "replication_plan.h"
+
+using namespace godot;
+
+HashMap<uint64_t, std::weak_ptr<const ReplicationPlan>> ReplicationPlan::_cache;
+
+std::shared_ptr<const ReplicationPlan> ReplicationPlan::get_or_compile(const Ref<SceneReplicationConfig> &p_config) {
+	if (p_config.is_null()) {
+		return std::make_shared<const ReplicationPlan>();
+	}
+
+	const uint64_t key = p_config->get_instance_id();
+	if (std::weak_ptr<const ReplicationPlan> *cached = _cache.getptr(key)) {
+		if (std::shared_ptr<const ReplicationPlan> plan = cached->lock()) {
+			return plan;
+		}
+	}
+
+	// The deleter drops the cache entry along with the last reference, so configs that are no longer used do not
+	// accumulate. It only erases the entry if it still refers to this plan, not a newer one compiled after invalidate().
+	ReplicationPlan *compiled = memnew(ReplicationPlan);
+	std::shared_ptr<ReplicationPlan> plan(compiled, [key](ReplicationPlan *p_plan) {
+		if (std::weak_ptr<const ReplicationPlan> *cached = _cache.getptr(key)) {
+			if (cached->expired()) {
+				_cache.erase(key);
+			}
+		}
+		memdelete(p_plan);
+	});
+	plan->_compile(p_config);
+	_cache[key] = plan;
+	return plan;
+}
+
+void ReplicationPlan::invalidate(const Ref<SceneReplicationConfig> &p_config) {
+	if (p_config.is_valid()) {
+		_cache.erase(p_config->get_instance_id());
+	}
+}
+
+void ReplicationPlan::cleanup() {
+	_cache.clear();
+}
+
+uint32_t ReplicationPlan::hash_config(const Ref<SceneReplicationConfig> &p_config) {
+	if (p_config.is_null()) {
+		return 0;
+	}
+	const TypedArray<NodePath> props = p_config->get_properties();
+	uint32_t hash = hash_murmur3_one_32(props.size());
+	for (int64_t i = 0; i < props.size(); i++) {
+		const NodePath prop = props[i];
+		hash = hash_murmur3_one_32(prop.hash(), hash);
+		hash = hash_murmur3_one_32((p_config->property_get_sync(prop) ? 1 : 0) | (p_config->property_get_watch(prop) ? 2 : 0), hash);
+	}
+	return hash_fmix32(hash);
+}
+
+void ReplicationPlan::_compile(const Ref<SceneReplicationConfig> &p_config) {
+	config_hash = hash_config(p_config);
+	const TypedArray<NodePath> props = p_config->get_properties();
+	const int64_t count = props.size();
+	properties.resize(count);
+
+	for (int64_t i = 0; i < count; i++) {
+		const NodePath prop = props[i];
+		Property &entry = properties[i];
+		entry.path = prop;
+		entry.sync = p_config->property_get_sync(prop);
+		entry.watch = p_config->property_get_watch(prop);
+
+		const int64_t subname_count = prop.get_subname_count();
+		entry.subnames.resize(subname_count);
+		for (int64_t j = 0; j < subname_count; j++) {
+			entry.subnames.set(j, prop.get_subname(j));
+		}
+
+		// Properties on the same node share a single target binding.
+		NodePath target_path;
+		if (prop.get_name_count() > 0) {
+			String names = prop.get_concatenated_names();
+			target_path = NodePath(prop.is_absolute() ? "/" + names : names);
+		}
+		int64_t target = target_paths.find(target_path);
+		if (target < 0) {
+			target = target_paths.size();
+			target_paths.push_back(target_path);
+		}
+		entry.target = target;
+
+		property_indices[prop] = i;
+		if (entry.sync) {
+			sync_indices.push_back(i);
+			sync_properties.push_back(prop);
+		}
+		if (entry.watch) {
+			entry.watch_index = watch_indices.size();
+			watch_indices.push_back(i);
+			watch_properties.push_back(prop);
+		}
+	}
+}
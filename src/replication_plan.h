@@ -0,0 +1,54 @@
+#pragma once
+
+#include <godot_cpp/classes/scene_replication_config.hpp>
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/vector.hpp>
+
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+#include <memory>
+
+namespace godot {
+
+// Immutable compilation of a SceneReplicationConfig. Plans are shared by every SceneSynchronizer using the same config
+// resource, so instances carry their own target bindings and everything resolved from them, such as property types.
+class ReplicationPlan {
+public:
+	struct Property {
+		NodePath path;
+		Vector<StringName> subnames;
+		uint32_t target = 0;
+		bool sync = false;
+		bool watch = false;
+		// Position in watch_indices, -1 if not watched.
+		int32_t watch_index = -1;
+	};
+
+	LocalVector<Property> properties;
+	LocalVector<uint32_t> sync_indices;
+	LocalVector<uint32_t> watch_indices;
+	LocalVector<NodePath> target_paths;
+	HashMap<NodePath, uint32_t> property_indices;
+	TypedArray<NodePath> sync_properties;
+	TypedArray<NodePath> watch_properties;
+	// hash_config() of the config this plan was compiled from.
+	uint32_t config_hash = 0;
+
+	static std::shared_ptr<const ReplicationPlan> get_or_compile(const Ref<SceneReplicationConfig> &p_config);
+	static void invalidate(const Ref<SceneReplicationConfig> &p_config);
+	static void cleanup();
+	// Hash of the config's property paths and sync/watch flags, to detect edits made without emitting `changed`.
+	static uint32_t hash_config(const Ref<SceneReplicationConfig> &p_config);
+
+private:
+	static HashMap<uint64_t, std::weak_ptr<const ReplicationPlan>> _cache;
+
+	void _compile(const Ref<SceneReplicationConfig> &p_config);
+};
+
+} //namespace godot
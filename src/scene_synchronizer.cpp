@@ -1,5 +1,13 @@
 #include "scene_synchronizer.h"
 
+#include "scene_synchronizer_server.h"
+
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include <cstring>
+
 using namespace godot;
 
 Object *SceneSynchronizer::_get_prop_target(Object *p_obj, const NodePath &p_path) {
@@ -30,7 +38,12 @@ void SceneSynchronizer::_stop() {
 	}
 #endif
 	root_node_cache = ObjectID();
+	_unbind_plan();
 	reset();
+
+	if (SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton()) {
+		server->unregister_synchronizer(this);
+	}
 }
 
 void SceneSynchronizer::_start() {
@@ -40,11 +53,17 @@ void SceneSynchronizer::_start() {
 	}
 #endif
 	root_node_cache = ObjectID();
+	_unbind_plan();
 	reset();
 	Node *node = is_inside_tree() ? get_node_or_null(root_path) : nullptr;
 	if (node) {
 		root_node_cache = node->get_instance_id();
 		_update_process();
+
+		SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton();
+		if (server && server_index < 0) {
+			server->register_synchronizer(this);
+		}
 	}
 }
 
@@ -58,21 +77,38 @@ void SceneSynchronizer::_update_process() {
 	if (!node) {
 		return;
 	}
-	set_process_internal(false);
+	set_process_internal(interpolation_enabled || !property_extrapolations.is_empty());
 	set_physics_process_internal(false);
 }
 
+void SceneSynchronizer::_notification(int p_what) {
+	if (p_what != NOTIFICATION_INTERNAL_PROCESS) {
+		return;
+	}
+	// Interpolated values already trail the received ones, so they are never extrapolated as well.
+	if (interpolation_enabled) {
+		_process_interpolation();
+	} else if (!property_extrapolations.is_empty()) {
+		_process_extrapolation();
+	}
+}
+
 Node *SceneSynchronizer::get_root_node() {
 	return root_node_cache.is_valid() ? cast_to<Node>(ObjectDB::get_instance(root_node_cache)) : nullptr;
 }
 
 void SceneSynchronizer::reset() {
-	net_id = 0;
+	set_net_id(0);
 	last_sync_usec = 0;
 	last_inbound_sync = 0;
 	last_watch_usec = 0;
 	sync_started = false;
-	watchers.clear();
+	_clear_watchers();
+	_clear_snapshots();
+	_clear_predictions();
+	_clear_baselines();
+	history.reset();
+	extrapolations_dirty = true;
 }
 
 uint32_t SceneSynchronizer::get_net_id() const {
@@ -80,7 +116,16 @@ uint32_t SceneSynchronizer::get_net_id() const {
 }
 
 void SceneSynchronizer::set_net_id(uint32_t p_net_id) {
+	if (net_id == p_net_id) {
+		return;
+	}
+	const uint32_t previous = net_id;
 	net_id = p_net_id;
+	if (server_index >= 0) {
+		if (SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton()) {
+			server->update_net_id(this, previous);
+		}
+	}
 }
 
 bool SceneSynchronizer::update_outbound_sync_time(uint64_t p_usec) {
@@ -137,43 +182,41 @@ void SceneSynchronizer::_set_indexed(Object *p_obj, const Vector<StringName> &p_
 		r_valid = &valid;
 	}
 
-	List<Variant> value_stack;
-	Variant current_value = p_obj->get(p_names[0]);
+	// Values along the path, outermost first. Paths are rarely more than a couple of subnames deep, so they are kept on
+	// the stack rather than allocated per call.
+	const int depth = p_names.size();
+	Variant inline_values[8];
+	LocalVector<Variant> heap_values;
+	Variant *values = inline_values;
+	if (unlikely(depth > 8)) {
+		heap_values.resize(depth);
+		values = heap_values.ptr();
+	}
 
-	if (current_value.get_type() == Variant::NIL) {
-		value_stack.clear();
+	values[0] = p_obj->get(p_names[0]);
+	if (values[0].get_type() == Variant::NIL) {
 		return;
 	}
 
-	value_stack.push_back(current_value);
-
-	for (int i = 1; i < p_names.size() - 1; i++) {
-		value_stack.push_back(value_stack.back()->get().get_named(p_names[i], valid));
+	for (int i = 1; i < depth - 1; i++) {
+		values[i] = values[i - 1].get_named(p_names[i], valid);
 		*r_valid = valid;
-
 		if (!valid) {
-			value_stack.clear();
 			return;
 		}
 	}
 
-	value_stack.push_back(p_value); // p_names[p_names.size() - 1]
-
-	for (int i = p_names.size() - 1; i > 0; i--) {
-		value_stack.back()->prev()->get().set_named(p_names[i], value_stack.back()->get(), valid);
-		value_stack.pop_back();
+	values[depth - 1] = p_value; // p_names[depth - 1]
 
+	for (int i = depth - 1; i > 0; i--) {
+		values[i - 1].set_named(p_names[i], values[i], valid);
 		*r_valid = valid;
 		if (!valid) {
-			value_stack.clear();
 			return;
 		}
 	}
 
-	p_obj->set(p_names[0], value_stack.back()->get());
-	value_stack.pop_back();
-
-	ERR_FAIL_COND(!value_stack.is_empty());
+	p_obj->set(p_names[0], values[0]);
 }
 
 Variant SceneSynchronizer::_get_indexed(const Object *p_obj, const Vector<StringName> &p_names, bool *r_valid) {
@@ -239,6 +282,71 @@ void SceneSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_delta_interval", "milliseconds"), &SceneSynchronizer::set_delta_interval);
 	ClassDB::bind_method(D_METHOD("get_delta_interval"), &SceneSynchronizer::get_delta_interval);
 
+	ClassDB::bind_method(D_METHOD("set_watch_mode", "mode"), &SceneSynchronizer::set_watch_mode);
+	ClassDB::bind_method(D_METHOD("get_watch_mode"), &SceneSynchronizer::get_watch_mode);
+	ClassDB::bind_method(D_METHOD("mark_dirty", "property"), &SceneSynchronizer::mark_dirty);
+	ClassDB::bind_method(D_METHOD("mark_dirty_index", "watch_index"), &SceneSynchronizer::mark_dirty_index);
+	ClassDB::bind_method(D_METHOD("mark_all_dirty"), &SceneSynchronizer::mark_all_dirty);
+
+	ClassDB::bind_method(D_METHOD("set_replication_priority", "priority"), &SceneSynchronizer::set_replication_priority);
+	ClassDB::bind_method(D_METHOD("get_replication_priority"), &SceneSynchronizer::get_replication_priority);
+
+	ClassDB::bind_method(D_METHOD("set_change_stats_enabled", "enabled"), &SceneSynchronizer::set_change_stats_enabled);
+	ClassDB::bind_method(D_METHOD("is_change_stats_enabled"), &SceneSynchronizer::is_change_stats_enabled);
+	ClassDB::bind_method(D_METHOD("set_hot_change_rate", "rate"), &SceneSynchronizer::set_hot_change_rate);
+	ClassDB::bind_method(D_METHOD("get_hot_change_rate"), &SceneSynchronizer::get_hot_change_rate);
+	ClassDB::bind_method(D_METHOD("set_cold_change_rate", "rate"), &SceneSynchronizer::set_cold_change_rate);
+	ClassDB::bind_method(D_METHOD("get_cold_change_rate"), &SceneSynchronizer::get_cold_change_rate);
+	ClassDB::bind_method(D_METHOD("set_min_change_samples", "samples"), &SceneSynchronizer::set_min_change_samples);
+	ClassDB::bind_method(D_METHOD("get_min_change_samples"), &SceneSynchronizer::get_min_change_samples);
+	ClassDB::bind_method(D_METHOD("reset_change_stats"), &SceneSynchronizer::reset_change_stats);
+	ClassDB::bind_method(D_METHOD("get_change_report"), &SceneSynchronizer::get_change_report);
+	ClassDB::bind_method(D_METHOD("apply_classification", "report"), &SceneSynchronizer::apply_classification);
+	ClassDB::bind_method(D_METHOD("apply_suggested_classification"), &SceneSynchronizer::apply_suggested_classification);
+
+	ClassDB::bind_method(D_METHOD("set_interpolation_enabled", "enabled"), &SceneSynchronizer::set_interpolation_enabled);
+	ClassDB::bind_method(D_METHOD("is_interpolation_enabled"), &SceneSynchronizer::is_interpolation_enabled);
+	ClassDB::bind_method(D_METHOD("set_interpolation_delay", "delay"), &SceneSynchronizer::set_interpolation_delay);
+	ClassDB::bind_method(D_METHOD("get_interpolation_delay"), &SceneSynchronizer::get_interpolation_delay);
+	ClassDB::bind_method(D_METHOD("set_network_tick_rate", "rate"), &SceneSynchronizer::set_network_tick_rate);
+	ClassDB::bind_method(D_METHOD("get_network_tick_rate"), &SceneSynchronizer::get_network_tick_rate);
+	ClassDB::bind_method(D_METHOD("set_interpolation_buffer_size", "size"), &SceneSynchronizer::set_interpolation_buffer_size);
+	ClassDB::bind_method(D_METHOD("get_interpolation_buffer_size"), &SceneSynchronizer::get_interpolation_buffer_size);
+	ClassDB::bind_method(D_METHOD("push_sync_snapshot", "network_time", "sync_values"), &SceneSynchronizer::push_sync_snapshot);
+	ClassDB::bind_method(D_METHOD("push_sync_snapshot_packed", "network_time", "state"), &SceneSynchronizer::push_sync_snapshot_packed);
+	ClassDB::bind_method(D_METHOD("get_snapshot_count"), &SceneSynchronizer::get_snapshot_count);
+
+	ClassDB::bind_method(D_METHOD("set_prediction_enabled", "enabled"), &SceneSynchronizer::set_prediction_enabled);
+	ClassDB::bind_method(D_METHOD("is_prediction_enabled"), &SceneSynchronizer::is_prediction_enabled);
+	ClassDB::bind_method(D_METHOD("set_prediction_threshold", "threshold"), &SceneSynchronizer::set_prediction_threshold);
+	ClassDB::bind_method(D_METHOD("get_prediction_threshold"), &SceneSynchronizer::get_prediction_threshold);
+	ClassDB::bind_method(D_METHOD("set_prediction_buffer_size", "size"), &SceneSynchronizer::set_prediction_buffer_size);
+	ClassDB::bind_method(D_METHOD("get_prediction_buffer_size"), &SceneSynchronizer::get_prediction_buffer_size);
+	ClassDB::bind_method(D_METHOD("set_resimulate_callback", "callback"), &SceneSynchronizer::set_resimulate_callback);
+	ClassDB::bind_method(D_METHOD("get_resimulate_callback"), &SceneSynchronizer::get_resimulate_callback);
+	ClassDB::bind_method(D_METHOD("record_prediction", "network_time", "input"), &SceneSynchronizer::record_prediction);
+	ClassDB::bind_method(D_METHOD("reconcile_sync_state", "network_time", "sync_values"), &SceneSynchronizer::reconcile_sync_state);
+	ClassDB::bind_method(D_METHOD("reconcile_sync_state_packed", "network_time", "state"), &SceneSynchronizer::reconcile_sync_state_packed);
+	ClassDB::bind_method(D_METHOD("get_prediction_count"), &SceneSynchronizer::get_prediction_count);
+	ClassDB::bind_method(D_METHOD("get_resimulation_count"), &SceneSynchronizer::get_resimulation_count);
+
+	ClassDB::bind_method(D_METHOD("set_history_enabled", "enabled"), &SceneSynchronizer::set_history_enabled);
+	ClassDB::bind_method(D_METHOD("is_history_enabled"), &SceneSynchronizer::is_history_enabled);
+	ClassDB::bind_method(D_METHOD("set_history_size", "size"), &SceneSynchronizer::set_history_size);
+	ClassDB::bind_method(D_METHOD("get_history_size"), &SceneSynchronizer::get_history_size);
+	ClassDB::bind_method(D_METHOD("record_history", "usec"), &SceneSynchronizer::record_history);
+	ClassDB::bind_method(D_METHOD("get_history_state", "usec"), &SceneSynchronizer::get_history_state);
+	ClassDB::bind_method(D_METHOD("get_history_position", "usec"), &SceneSynchronizer::get_history_position);
+	ClassDB::bind_method(D_METHOD("get_history_count"), &SceneSynchronizer::get_history_count);
+
+	ClassDB::bind_method(D_METHOD("set_property_extrapolations", "extrapolations"), &SceneSynchronizer::set_property_extrapolations);
+	ClassDB::bind_method(D_METHOD("get_property_extrapolations"), &SceneSynchronizer::get_property_extrapolations);
+	ClassDB::bind_method(D_METHOD("set_property_extrapolation", "property", "model", "threshold", "velocity_property"), &SceneSynchronizer::set_property_extrapolation, DEFVAL(NodePath()));
+	ClassDB::bind_method(D_METHOD("clear_property_extrapolation", "property"), &SceneSynchronizer::clear_property_extrapolation);
+
+	ClassDB::bind_method(D_METHOD("set_transform_channel_enabled", "enabled"), &SceneSynchronizer::set_transform_channel_enabled);
+	ClassDB::bind_method(D_METHOD("is_transform_channel_enabled"), &SceneSynchronizer::is_transform_channel_enabled);
+
 	ClassDB::bind_method(D_METHOD("get_replication_config"), &SceneSynchronizer::get_replication_config);
 
 	ClassDB::bind_method(D_METHOD("get_net_id"), &SceneSynchronizer::get_net_id);
@@ -256,6 +364,22 @@ void SceneSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_sync_state", "cur_usec", "last_usec", "sync_props", "sync_values"), &SceneSynchronizer::get_sync_state);
 	ClassDB::bind_method(D_METHOD("get_sync_state_encoded", "cur_usec", "last_usec", "sync_props", "sync_values"), &SceneSynchronizer::get_sync_state_encoded);
 
+	ClassDB::bind_method(D_METHOD("get_delta_state_compact", "cur_usec", "last_usec", "delta_values"), &SceneSynchronizer::get_delta_state_compact);
+	ClassDB::bind_method(D_METHOD("set_delta_state_compact", "delta_mask", "delta_values"), &SceneSynchronizer::set_delta_state_compact);
+
+	ClassDB::bind_method(D_METHOD("get_sync_state_packed", "cur_usec", "last_usec"), &SceneSynchronizer::get_sync_state_packed);
+	ClassDB::bind_method(D_METHOD("get_delta_state_packed", "cur_usec", "last_usec"), &SceneSynchronizer::get_delta_state_packed);
+	ClassDB::bind_method(D_METHOD("set_sync_state_packed", "state"), &SceneSynchronizer::set_sync_state_packed);
+	ClassDB::bind_method(D_METHOD("set_delta_state_packed", "state"), &SceneSynchronizer::set_delta_state_packed);
+
+	ClassDB::bind_method(D_METHOD("set_sync_state", "sync_values"), &SceneSynchronizer::set_sync_state);
+	ClassDB::bind_method(D_METHOD("set_delta_state", "delta_props", "delta_values"), &SceneSynchronizer::set_delta_state);
+
+	ClassDB::bind_method(D_METHOD("set_property_encodings", "encodings"), &SceneSynchronizer::set_property_encodings);
+	ClassDB::bind_method(D_METHOD("get_property_encodings"), &SceneSynchronizer::get_property_encodings);
+	ClassDB::bind_method(D_METHOD("set_property_encoding", "property", "encoding", "min", "max", "bits"), &SceneSynchronizer::set_property_encoding, DEFVAL(0.0), DEFVAL(1.0), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("clear_property_encoding", "property"), &SceneSynchronizer::clear_property_encoding);
+
 	ClassDB::bind_method(D_METHOD("get_delta_properties"), &SceneSynchronizer::get_delta_properties);
 	ClassDB::bind_method(D_METHOD("get_watch_properties"), &SceneSynchronizer::get_delta_properties);
 
@@ -263,11 +387,53 @@ void SceneSynchronizer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_path"), "set_root_path", "get_root_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "replication_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_replication_interval", "get_replication_interval");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "delta_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_delta_interval", "get_delta_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "watch_mode", PROPERTY_HINT_ENUM, "Poll,Dirty"), "set_watch_mode", "get_watch_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "replication_priority", PROPERTY_HINT_RANGE, "0.01,100,0.01,or_greater"), "set_replication_priority", "get_replication_priority");
+	ADD_GROUP("Interpolation", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "interpolation_enabled"), "set_interpolation_enabled", "is_interpolation_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "interpolation_delay", PROPERTY_HINT_RANGE, "0,1,0.001,suffix:s"), "set_interpolation_delay", "get_interpolation_delay");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "network_tick_rate", PROPERTY_HINT_RANGE, "1,240,1,or_greater,suffix:Hz"), "set_network_tick_rate", "get_network_tick_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "interpolation_buffer_size", PROPERTY_HINT_RANGE, "2,256,1"), "set_interpolation_buffer_size", "get_interpolation_buffer_size");
+	ADD_GROUP("Prediction", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "prediction_enabled"), "set_prediction_enabled", "is_prediction_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "prediction_threshold", PROPERTY_HINT_RANGE, "0,10,0.001,or_greater"), "set_prediction_threshold", "get_prediction_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "prediction_buffer_size", PROPERTY_HINT_RANGE, "2,1024,1"), "set_prediction_buffer_size", "get_prediction_buffer_size");
+	ADD_PROPERTY(PropertyInfo(Variant::CALLABLE, "resimulate_callback"), "set_resimulate_callback", "get_resimulate_callback");
+	ADD_GROUP("Lag Compensation", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "history_enabled"), "set_history_enabled", "is_history_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "history_size", PROPERTY_HINT_RANGE, "2,1024,1"), "set_history_size", "get_history_size");
+	ADD_GROUP("Change Statistics", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "change_stats_enabled"), "set_change_stats_enabled", "is_change_stats_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "hot_change_rate", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_hot_change_rate", "get_hot_change_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cold_change_rate", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_cold_change_rate", "get_cold_change_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "min_change_samples", PROPERTY_HINT_RANGE, "1,10000,1,or_greater"), "set_min_change_samples", "get_min_change_samples");
+	ADD_GROUP("", "");
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "transform_channel_enabled"), "set_transform_channel_enabled", "is_transform_channel_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "property_encodings"), "set_property_encodings", "get_property_encodings");
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "property_extrapolations"), "set_property_extrapolations", "get_property_extrapolations");
+
+	BIND_ENUM_CONSTANT(WATCH_MODE_POLL);
+	BIND_ENUM_CONSTANT(WATCH_MODE_DIRTY);
+
+	BIND_ENUM_CONSTANT(PROPERTY_ENCODING_DEFAULT);
+	BIND_ENUM_CONSTANT(PROPERTY_ENCODING_FIXED_POINT);
+	BIND_ENUM_CONSTANT(PROPERTY_ENCODING_HALF_FLOAT);
+	BIND_ENUM_CONSTANT(PROPERTY_ENCODING_SMALLEST_THREE);
+	BIND_ENUM_CONSTANT(PROPERTY_ENCODING_BITS);
+
+	BIND_ENUM_CONSTANT(EXTRAPOLATION_NONE);
+	BIND_ENUM_CONSTANT(EXTRAPOLATION_LINEAR);
+	BIND_ENUM_CONSTANT(EXTRAPOLATION_VELOCITY);
 }
 
 void SceneSynchronizer::set_replication_interval(double p_interval) {
 	ERR_FAIL_COND_MSG(p_interval < 0, "Interval must be greater or equal to 0 (where 0 means default)");
 	sync_interval_usec = uint64_t(p_interval * 1000 * 1000);
+
+	if (SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton()) {
+		server->update_intervals(this);
+	}
 }
 
 double SceneSynchronizer::get_replication_interval() const {
@@ -277,19 +443,198 @@ double SceneSynchronizer::get_replication_interval() const {
 void SceneSynchronizer::set_delta_interval(double p_interval) {
 	ERR_FAIL_COND_MSG(p_interval < 0, "Interval must be greater or equal to 0 (where 0 means default)");
 	delta_interval_usec = uint64_t(p_interval * 1000 * 1000);
+
+	if (SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton()) {
+		server->update_intervals(this);
+	}
 }
 
 double SceneSynchronizer::get_delta_interval() const {
 	return double(delta_interval_usec) / 1000.0 / 1000.0;
 }
 
+void SceneSynchronizer::set_watch_mode(WatchMode p_mode) {
+	watch_mode = p_mode;
+	// Switching modes starts over with a full poll.
+	watchers_primed = false;
+}
+
+SceneSynchronizer::WatchMode SceneSynchronizer::get_watch_mode() const {
+	return watch_mode;
+}
+
+void SceneSynchronizer::mark_dirty(const NodePath &p_property) {
+	const uint32_t *index = _get_plan().property_indices.getptr(p_property);
+	ERR_FAIL_NULL_MSG(index, vformat("Property '%s' is not replicated.", p_property));
+	const int32_t watch_index = plan->properties[*index].watch_index;
+	ERR_FAIL_COND_MSG(watch_index < 0, vformat("Property '%s' is not watched.", p_property));
+	mark_dirty_index(watch_index);
+}
+
+void SceneSynchronizer::mark_dirty_index(int p_watch_index) {
+	if (!watchers_primed) {
+		// Everything is sampled on the next watch anyway.
+		return;
+	}
+	ERR_FAIL_INDEX(p_watch_index, int(watchers.size()));
+	Watcher &w = watchers[p_watch_index];
+	if (!w.dirty) {
+		w.dirty = true;
+		dirty_watchers.push_back(p_watch_index);
+	}
+}
+
+void SceneSynchronizer::mark_all_dirty() {
+	watchers_primed = false;
+}
+
+void SceneSynchronizer::set_replication_priority(float p_priority) {
+	ERR_FAIL_COND_MSG(p_priority <= 0, "Replication priority must be greater than 0.");
+	replication_priority = p_priority;
+}
+
+float SceneSynchronizer::get_replication_priority() const {
+	return replication_priority;
+}
+
+void SceneSynchronizer::set_change_stats_enabled(bool p_enabled) {
+	change_stats_enabled = p_enabled;
+}
+
+bool SceneSynchronizer::is_change_stats_enabled() const {
+	return change_stats_enabled;
+}
+
+void SceneSynchronizer::set_hot_change_rate(double p_rate) {
+	ERR_FAIL_COND_MSG(p_rate < 0 || p_rate > 1, "Change rate must be between 0 and 1.");
+	hot_change_rate = p_rate;
+}
+
+double SceneSynchronizer::get_hot_change_rate() const {
+	return hot_change_rate;
+}
+
+void SceneSynchronizer::set_cold_change_rate(double p_rate) {
+	ERR_FAIL_COND_MSG(p_rate < 0 || p_rate > 1, "Change rate must be between 0 and 1.");
+	cold_change_rate = p_rate;
+}
+
+double SceneSynchronizer::get_cold_change_rate() const {
+	return cold_change_rate;
+}
+
+void SceneSynchronizer::set_min_change_samples(int p_samples) {
+	ERR_FAIL_COND_MSG(p_samples < 1, "Minimum change samples must be at least 1.");
+	min_change_samples = p_samples;
+}
+
+int SceneSynchronizer::get_min_change_samples() const {
+	return min_change_samples;
+}
+
+void SceneSynchronizer::set_interpolation_enabled(bool p_enabled) {
+	interpolation_enabled = p_enabled;
+	_clear_snapshots();
+	_update_process();
+}
+
+bool SceneSynchronizer::is_interpolation_enabled() const {
+	return interpolation_enabled;
+}
+
+void SceneSynchronizer::set_interpolation_delay(double p_delay) {
+	ERR_FAIL_COND_MSG(p_delay < 0, "Interpolation delay must be greater or equal to 0.");
+	interpolation_delay = p_delay;
+}
+
+double SceneSynchronizer::get_interpolation_delay() const {
+	return interpolation_delay;
+}
+
+void SceneSynchronizer::set_network_tick_rate(double p_rate) {
+	ERR_FAIL_COND_MSG(p_rate <= 0, "Network tick rate must be greater than 0.");
+	network_tick_rate = p_rate;
+	_clear_snapshots();
+}
+
+double SceneSynchronizer::get_network_tick_rate() const {
+	return network_tick_rate;
+}
+
+void SceneSynchronizer::set_interpolation_buffer_size(int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 2, "Interpolation buffer must hold at least 2 snapshots.");
+	interpolation_buffer_size = p_size;
+	_clear_snapshots();
+}
+
+int SceneSynchronizer::get_interpolation_buffer_size() const {
+	return interpolation_buffer_size;
+}
+
+void SceneSynchronizer::set_prediction_enabled(bool p_enabled) {
+	prediction_enabled = p_enabled;
+	_clear_predictions();
+}
+
+bool SceneSynchronizer::is_prediction_enabled() const {
+	return prediction_enabled;
+}
+
+void SceneSynchronizer::set_prediction_threshold(double p_threshold) {
+	ERR_FAIL_COND_MSG(p_threshold < 0, "Prediction threshold must be greater or equal to 0.");
+	prediction_threshold = p_threshold;
+}
+
+double SceneSynchronizer::get_prediction_threshold() const {
+	return prediction_threshold;
+}
+
+void SceneSynchronizer::set_prediction_buffer_size(int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 2, "Prediction buffer must hold at least 2 frames.");
+	prediction_buffer_size = p_size;
+	_clear_predictions();
+}
+
+int SceneSynchronizer::get_prediction_buffer_size() const {
+	return prediction_buffer_size;
+}
+
+void SceneSynchronizer::set_resimulate_callback(const Callable &p_callback) {
+	resimulate_callback = p_callback;
+}
+
+Callable SceneSynchronizer::get_resimulate_callback() const {
+	return resimulate_callback;
+}
+
+void SceneSynchronizer::set_transform_channel_enabled(bool p_enabled) {
+	transform_channel_enabled = p_enabled;
+}
+
+bool SceneSynchronizer::is_transform_channel_enabled() const {
+	return transform_channel_enabled;
+}
+
+// The compiled plan follows the config's `changed` signal. SceneReplicationConfig does not emit it from
+// property_set_sync(), property_set_watch(), add_property() or remove_property(), so runtime edits must be followed by
+// emit_changed() to take effect immediately; otherwise they are only picked up the next time the targets are bound.
 Ref<SceneReplicationConfig> SceneSynchronizer::get_replication_config() {
 	return replication_config;
 }
 
 void SceneSynchronizer::set_multiplayer_synchronizer(MultiplayerSynchronizer *p_synchronizer) {
+	Callable config_changed = callable_mp(this, &SceneSynchronizer::_on_replication_config_changed);
+	if (replication_config.is_valid() && replication_config->is_connected("changed", config_changed)) {
+		replication_config->disconnect("changed", config_changed);
+	}
+
 	multiplayer_synchronizer = p_synchronizer;
 	replication_config = multiplayer_synchronizer ? multiplayer_synchronizer->get_replication_config() : Ref<SceneReplicationConfig>();
+
+	if (replication_config.is_valid()) {
+		replication_config->connect("changed", config_changed);
+	}
+	_invalidate_plan();
 	update_configuration_warnings();
 }
 
@@ -311,140 +656,1602 @@ NodePath SceneSynchronizer::get_root_path() const {
 	return root_path;
 }
 
-// TODO: Caching? Godot internal has access to these without copying. Unfortunately, they're not exposed. Even if they
-//       were, the API would almost certainly return a copy.
-TypedArray<NodePath> SceneSynchronizer::_get_sync_properties() {
-	TypedArray<NodePath> sync_props;
-	if (replication_config.is_null()) {
-		return sync_props;
+void SceneSynchronizer::_invalidate_plan() {
+	_clear_snapshots();
+	_clear_predictions();
+	history.reset();
+	_clear_baselines();
+	plan.reset();
+	plan_targets.clear();
+	plan_bindings.clear();
+	plan_bound = false;
+	_clear_watchers();
+	reset_change_stats();
+}
+
+void SceneSynchronizer::_unbind_plan() {
+	plan_bound = false;
+	for (ObjectID &target : plan_targets) {
+		target = ObjectID();
+	}
+}
+
+void SceneSynchronizer::_on_replication_config_changed() {
+	ReplicationPlan::invalidate(replication_config);
+	_invalidate_plan();
+}
+
+const ReplicationPlan &SceneSynchronizer::_get_plan() {
+	if (unlikely(!plan)) {
+		plan = ReplicationPlan::get_or_compile(replication_config);
+		plan_targets.resize(plan->target_paths.size());
+		encoding_profiles_dirty = true;
+		extrapolations_dirty = true;
+		_unbind_plan();
 	}
+	return *plan;
+}
 
-	TypedArray<NodePath> all_props = replication_config->get_properties();
-	sync_props.resize(all_props.size());
-	int count = 0;
+bool SceneSynchronizer::_bind_plan() {
+	const ReplicationPlan &p = _get_plan();
+	Node *root = get_root_node();
+	if (!root) {
+		return false;
+	}
 
-	for (NodePath prop : replication_config->get_properties()) {
-		if (replication_config->property_get_sync(prop)) {
-			sync_props.push_back(prop);
-			count++;
+	if (plan_bound) {
+		// Cheap validation: a bound node that was freed or left the tree invalidates the bindings.
+		for (const ObjectID &target : plan_targets) {
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(target));
+			if (unlikely(!node || !node->is_inside_tree())) {
+				plan_bound = false;
+				break;
+			}
 		}
+		if (likely(plan_bound)) {
+			return true;
+		}
+	}
+
+	if (unlikely(ReplicationPlan::hash_config(replication_config) != p.config_hash)) {
+		// The config was edited without emitting `changed`; recompile before binding to the stale property set.
+		_on_replication_config_changed();
+		return _bind_plan();
+	}
+
+	bool bound = true;
+	for (uint32_t i = 0; i < p.target_paths.size(); i++) {
+		Object *obj = _get_prop_target(root, p.target_paths[i]);
+		plan_targets[i] = obj ? ObjectID(obj->get_instance_id()) : ObjectID();
+		bound = bound && obj;
 	}
+	plan_bound = bound;
 
-	sync_props.resize(count);
-	return sync_props;
+	if (bound) {
+		// Targets may have been replaced by nodes whose properties are typed differently or that now have (or no longer
+		// have) a native accessor, so types and accessors are resolved against the targets just bound.
+		_resolve_plan_types();
+	} else {
+		// Some targets may already be new nodes; the previous accessors must not be used on them.
+		for (PlanBinding &binding : plan_bindings) {
+			binding.accessor = NativeAccessor::NONE;
+		}
+	}
+	return bound;
 }
 
-// TODO: Caching? Godot internal has access to these without copying. Unfortunately, they're not exposed. Even if they
-//       were, the API would almost certainly return a copy.
-TypedArray<NodePath> SceneSynchronizer::_get_watch_properties() {
-	TypedArray<NodePath> watch_props;
-	if (replication_config.is_null()) {
-		return watch_props;
+void SceneSynchronizer::_resolve_plan_types() {
+	const ReplicationPlan &p = *plan;
+	const bool rebinding = plan_bindings.size() == p.properties.size();
+	bool types_changed = false;
+	plan_bindings.resize(p.properties.size());
+
+	// Declared types of each target's properties. Variant-typed properties stay NIL and are tagged when encoded.
+	LocalVector<HashMap<StringName, Variant::Type>> declared_types;
+	declared_types.resize(plan_targets.size());
+	for (uint32_t i = 0; i < plan_targets.size(); i++) {
+		const Object *obj = ObjectDB::get_instance(plan_targets[i]);
+		ERR_CONTINUE(!obj);
+		const TypedArray<Dictionary> property_list = obj->get_property_list();
+		for (int64_t j = 0; j < property_list.size(); j++) {
+			const Dictionary info = property_list[j];
+			const uint32_t usage = info["usage"];
+			declared_types[i][info["name"]] = (usage & PROPERTY_USAGE_NIL_IS_VARIANT) ? Variant::NIL : Variant::Type(int(info["type"]));
+		}
+	}
+
+	for (uint32_t i = 0; i < p.properties.size(); i++) {
+		const ReplicationPlan::Property &prop = p.properties[i];
+		PlanBinding &binding = plan_bindings[i];
+		if (prop.subnames.is_empty()) {
+			continue;
+		}
+		const Variant::Type *declared = declared_types[prop.target].getptr(prop.subnames[0]);
+		Variant::Type type = declared ? *declared : Variant::NIL;
+		if (type != Variant::NIL && prop.subnames.size() > 1) {
+			// Sub-properties (e.g. position:x) take the type of the indexed value.
+			const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+			type = obj ? _get_indexed(obj, prop.subnames).get_type() : Variant::NIL;
+		}
+		types_changed = types_changed || binding.type != type;
+		binding.type = type;
+
+		// Built-in properties (and their vector components) bypass name lookup; deeper sub-paths stay generic.
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		NativeAccessor::Type accessor = NativeAccessor::resolve(obj, prop.subnames[0]);
+		int8_t component = -1;
+		if (accessor != NativeAccessor::NONE && prop.subnames.size() > 1) {
+			component = prop.subnames.size() == 2 ? NativeAccessor::resolve_component(prop.subnames[1]) : -1;
+			if (component < 0) {
+				accessor = NativeAccessor::NONE;
+			}
+		}
+		binding.accessor = accessor;
+		binding.component = component;
 	}
 
-	TypedArray<NodePath> all_props = replication_config->get_properties();
-	watch_props.resize(all_props.size());
-	int count = 0;
+	if (rebinding && types_changed) {
+		// Encoded baselines and history frames were laid out with the previous types.
+		_clear_baselines();
+		history.reset();
+	}
+}
+
+Variant SceneSynchronizer::_get_plan_value(const ReplicationPlan::Property &p_prop, const Object *p_obj) const {
+	const uint32_t index = &p_prop - plan->properties.ptr();
+	if (index < plan_bindings.size() && plan_bindings[index].accessor != NativeAccessor::NONE) {
+		const PlanBinding &binding = plan_bindings[index];
+		const Variant value = NativeAccessor::get(binding.accessor, p_obj);
+		return binding.component < 0 ? value : NativeAccessor::get_component(value, binding.component);
+	}
+	return _get_indexed(p_obj, p_prop.subnames);
+}
 
-	for (NodePath prop : replication_config->get_properties()) {
-		if (replication_config->property_get_watch(prop)) {
-			watch_props.push_back(prop);
-			count++;
+void SceneSynchronizer::_set_plan_value(const ReplicationPlan::Property &p_prop, Object *p_obj, const Variant &p_value) {
+	if (unlikely(!property_extrapolations.is_empty())) {
+		_update_extrapolations();
+		Extrapolation &extrapolation = extrapolations[&p_prop - plan->properties.ptr()];
+		if (extrapolation.model != EXTRAPOLATION_NONE) {
+			_set_reference(extrapolation, extrapolation.received, p_value, Time::get_singleton()->get_ticks_usec());
 		}
 	}
+	_write_plan_value(p_prop, p_obj, p_value);
+}
 
-	watch_props.resize(count);
-	return watch_props;
+void SceneSynchronizer::_write_plan_value(const ReplicationPlan::Property &p_prop, Object *p_obj, const Variant &p_value) {
+	const uint32_t index = &p_prop - plan->properties.ptr();
+	if (index < plan_bindings.size() && plan_bindings[index].accessor != NativeAccessor::NONE) {
+		const PlanBinding &binding = plan_bindings[index];
+		if (binding.component < 0) {
+			NativeAccessor::set(binding.accessor, p_obj, p_value);
+			return;
+		}
+		Variant value = NativeAccessor::get(binding.accessor, p_obj);
+		if (NativeAccessor::set_component(value, binding.component, p_value)) {
+			NativeAccessor::set(binding.accessor, p_obj, value);
+		}
+		return;
+	}
+	_set_indexed(p_obj, p_prop.subnames, p_value);
 }
 
-Error SceneSynchronizer::_watch_changes(uint64_t p_usec) {
-	ERR_FAIL_COND_V(replication_config.is_null(), FAILED);
-	const TypedArray<NodePath> props = _get_watch_properties();
+static bool _is_extrapolatable(Variant::Type p_type) {
+	return p_type == Variant::FLOAT || p_type == Variant::VECTOR2 || p_type == Variant::VECTOR3;
+}
 
-	if (props.size() != watchers.size()) {
-		watchers.resize(props.size());
+static Variant _extrapolate(const Variant &p_value, const Variant &p_rate, double p_seconds) {
+	if (p_value.get_type() != p_rate.get_type()) {
+		return p_value;
 	}
-	if (props.is_empty()) {
-		return OK;
+	switch (p_value.get_type()) {
+		case Variant::FLOAT:
+			return double(p_value) + double(p_rate) * p_seconds;
+		case Variant::VECTOR2:
+			return Vector2(p_value) + Vector2(p_rate) * real_t(p_seconds);
+		case Variant::VECTOR3:
+			return Vector3(p_value) + Vector3(p_rate) * real_t(p_seconds);
+		default:
+			return p_value;
 	}
-	Node *node = get_root_node();
-	ERR_FAIL_NULL_V(node, FAILED);
-	int idx = -1;
-	Watcher *ptr = watchers.ptrw();
-	for (const NodePath &prop : props) {
-		idx++;
-		const Object *obj = _get_prop_target(node, prop);
-		ERR_CONTINUE_MSG(!obj, vformat("Node not found for property '%s'.", prop));
-		Variant v = _get_indexed(obj, _get_subnames(prop));
-		ERR_CONTINUE_MSG(v.get_type() == Variant::NIL, vformat("Property '%s' not found.", prop));
-		Watcher &w = ptr[idx];
-		if (w.prop != prop) {
-			w.prop = prop;
-			w.value = v.duplicate(true);
-			w.last_change_usec = p_usec;
-		} else if (!w.value.hash_compare(v)) {
-			w.value = v.duplicate(true);
-			w.last_change_usec = p_usec;
-		}
+}
+
+// Change per second between two values, zero if it cannot be determined.
+static Variant _get_rate(const Variant &p_from, const Variant &p_to, double p_seconds) {
+	const bool valid = p_from.get_type() == p_to.get_type() && p_seconds > 0;
+	switch (p_to.get_type()) {
+		case Variant::FLOAT:
+			return valid ? (double(p_to) - double(p_from)) / p_seconds : 0.0;
+		case Variant::VECTOR2:
+			return valid ? (Vector2(p_to) - Vector2(p_from)) / real_t(p_seconds) : Vector2();
+		case Variant::VECTOR3:
+			return valid ? (Vector3(p_to) - Vector3(p_from)) / real_t(p_seconds) : Vector3();
+		default:
+			return Variant();
 	}
-	return OK;
 }
 
-void SceneSynchronizer::get_sync_state(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_sync_props, Array r_sync_values) {
-	if (p_cur_usec < p_last_usec + sync_interval_usec) {
-		// Too soon skip sync synchronization.
+// How far a predicted value is off. Values without a distance are either exact or infinitely wrong.
+static double _get_value_error(const Variant &p_predicted, const Variant &p_value) {
+	if (p_predicted.get_type() != p_value.get_type()) {
+		return Math_INF;
+	}
+	switch (p_value.get_type()) {
+		case Variant::INT:
+			return Math::abs(double(int64_t(p_value) - int64_t(p_predicted)));
+		case Variant::FLOAT:
+			return Math::abs(double(p_value) - double(p_predicted));
+		case Variant::VECTOR2:
+			return Vector2(p_value).distance_to(p_predicted);
+		case Variant::VECTOR3:
+			return Vector3(p_value).distance_to(p_predicted);
+		default:
+			return p_predicted == p_value ? 0.0 : Math_INF;
+	}
+}
+
+void SceneSynchronizer::set_property_extrapolations(const Dictionary &p_extrapolations) {
+	property_extrapolations = p_extrapolations.duplicate();
+	extrapolations_dirty = true;
+	_update_process();
+}
+
+Dictionary SceneSynchronizer::get_property_extrapolations() const {
+	return property_extrapolations.duplicate();
+}
+
+void SceneSynchronizer::set_property_extrapolation(const NodePath &p_property, ExtrapolationModel p_model, double p_threshold, const NodePath &p_velocity_property) {
+	ERR_FAIL_COND_MSG(p_threshold < 0, "Extrapolation threshold must be greater or equal to 0.");
+	ERR_FAIL_COND_MSG(p_model == EXTRAPOLATION_VELOCITY && p_velocity_property.is_empty(), "Velocity extrapolation requires a velocity property.");
+	if (p_model == EXTRAPOLATION_NONE) {
+		clear_property_extrapolation(p_property);
 		return;
 	}
+	Dictionary extrapolation;
+	extrapolation["model"] = p_model;
+	extrapolation["threshold"] = p_threshold;
+	extrapolation["velocity"] = p_velocity_property;
+	property_extrapolations[p_property] = extrapolation;
+	extrapolations_dirty = true;
+	_update_process();
+}
+
+void SceneSynchronizer::clear_property_extrapolation(const NodePath &p_property) {
+	property_extrapolations.erase(p_property);
+	extrapolations_dirty = true;
+	_update_process();
+}
 
-	Node *node = get_root_node();
-	r_sync_props = _get_sync_properties();
+void SceneSynchronizer::_update_extrapolations() {
+	if (likely(!extrapolations_dirty)) {
+		return;
+	}
+	const ReplicationPlan &p = _get_plan();
+	extrapolations_dirty = false;
+	extrapolations.clear();
+	if (property_extrapolations.is_empty()) {
+		return;
+	}
 
-	SceneSynchronizer::get_state(r_sync_props, node, r_sync_values);
+	extrapolations.resize(p.properties.size());
+	const Array keys = property_extrapolations.keys();
+	for (int64_t i = 0; i < keys.size(); i++) {
+		const NodePath path = keys[i];
+		const uint32_t *index = p.property_indices.getptr(path);
+		if (!index) {
+			WARN_PRINT(vformat("Extrapolation set for property '%s' which is not replicated.", path));
+			continue;
+		}
+		const Dictionary config = property_extrapolations[keys[i]];
+		const int model = config.get("model", EXTRAPOLATION_NONE);
+		ERR_CONTINUE_MSG(model < EXTRAPOLATION_NONE || model > EXTRAPOLATION_VELOCITY, vformat("Invalid extrapolation model for property '%s'.", path));
+
+		Extrapolation &extrapolation = extrapolations[*index];
+		if (model == EXTRAPOLATION_VELOCITY) {
+			const NodePath velocity_path = config.get("velocity", NodePath());
+			const uint32_t *velocity_index = p.property_indices.getptr(velocity_path);
+			ERR_CONTINUE_MSG(!velocity_index, vformat("Velocity property '%s' of '%s' is not replicated.", velocity_path, path));
+			extrapolation.velocity_index = *velocity_index;
+		}
+		extrapolation.model = ExtrapolationModel(model);
+		extrapolation.threshold = config.get("threshold", 0.0);
+	}
 }
 
-void SceneSynchronizer::get_sync_state_encoded(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_sync_props, TypedArray<PackedByteArray> r_sync_values_encoded) {
-	TypedArray<NodePath> sync_values;
-	SceneSynchronizer::get_sync_state(p_cur_usec, p_last_usec, r_sync_props, sync_values);
+Variant SceneSynchronizer::_predict(const Extrapolation &p_extrapolation, const Extrapolation::Reference &p_reference, uint64_t p_usec) {
+	const double seconds = p_usec > p_reference.usec ? double(p_usec - p_reference.usec) / 1000000.0 : 0.0;
+	if (p_extrapolation.model != EXTRAPOLATION_VELOCITY) {
+		return _extrapolate(p_reference.value, p_reference.rate, seconds);
+	}
+	// The velocity is replicated itself, so both ends see the same current value.
+	const ReplicationPlan::Property &velocity = plan->properties[p_extrapolation.velocity_index];
+	const Object *obj = ObjectDB::get_instance(plan_targets[velocity.target]);
+	return obj ? _extrapolate(p_reference.value, _get_plan_value(velocity, obj), seconds) : p_reference.value;
+}
 
-	r_sync_values_encoded.resize(sync_values.size());
-	for (int i = 0; i < sync_values.size(); i++) {
-		r_sync_values_encoded[i] = UtilityFunctions::var_to_bytes(sync_values[i]);
+void SceneSynchronizer::_set_reference(const Extrapolation &p_extrapolation, Extrapolation::Reference &r_reference, const Variant &p_value, uint64_t p_usec) {
+	if (p_extrapolation.model == EXTRAPOLATION_LINEAR) {
+		const double seconds = r_reference.valid && p_usec > r_reference.usec ? double(p_usec - r_reference.usec) / 1000000.0 : 0.0;
+		r_reference.rate = _get_rate(r_reference.value, p_value, seconds);
 	}
+	r_reference.value = p_value;
+	r_reference.usec = p_usec;
+	r_reference.valid = true;
 }
 
-void SceneSynchronizer::get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_delta_props, Array r_delta_values) {
-	if (last_watch_usec == p_cur_usec) {
-		// We already watched for changes in this frame.
+void SceneSynchronizer::_process_extrapolation() {
+	if (!_bind_plan()) {
+		return;
+	}
+	_update_extrapolations();
+	const uint64_t now = Time::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < extrapolations.size(); i++) {
+		const Extrapolation &extrapolation = extrapolations[i];
+		if (extrapolation.model == EXTRAPOLATION_NONE || !extrapolation.received.valid) {
+			continue;
+		}
+		const ReplicationPlan::Property &prop = plan->properties[i];
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		if (obj) {
+			_write_plan_value(prop, obj, _predict(extrapolation, extrapolation.received, now));
+		}
+	}
+}
 
-	} else if (p_cur_usec < p_last_usec + delta_interval_usec) {
-		// Too soon skip delta synchronization.
+void SceneSynchronizer::set_property_encodings(const Dictionary &p_encodings) {
+	property_encodings = p_encodings.duplicate();
+	encoding_profiles_dirty = true;
+}
+
+Dictionary SceneSynchronizer::get_property_encodings() const {
+	return property_encodings.duplicate();
+}
+
+void SceneSynchronizer::set_property_encoding(const NodePath &p_property, PropertyEncoding p_encoding, double p_min, double p_max, int p_bits) {
+	ERR_FAIL_COND_MSG(p_bits < 0 || p_bits > 32, "Encoding bits must be between 0 (default) and 32.");
+	if (p_encoding == PROPERTY_ENCODING_DEFAULT) {
+		clear_property_encoding(p_property);
+		return;
+	}
+	Dictionary encoding;
+	encoding["encoding"] = p_encoding;
+	encoding["min"] = p_min;
+	encoding["max"] = p_max;
+	encoding["bits"] = p_bits;
+	property_encodings[p_property] = encoding;
+	encoding_profiles_dirty = true;
+}
+
+void SceneSynchronizer::clear_property_encoding(const NodePath &p_property) {
+	property_encodings.erase(p_property);
+	encoding_profiles_dirty = true;
+}
+
+void SceneSynchronizer::_update_encoding_profiles() {
+	if (likely(!encoding_profiles_dirty)) {
+		return;
+	}
+	const ReplicationPlan &p = _get_plan();
+	encoding_profiles_dirty = false;
+	encoding_profiles.clear();
+	if (property_encodings.is_empty()) {
 		return;
+	}
+
+	encoding_profiles.resize(p.properties.size());
+	const Array keys = property_encodings.keys();
+	for (int64_t i = 0; i < keys.size(); i++) {
+		const NodePath path = keys[i];
+		const uint32_t *index = p.property_indices.getptr(path);
+		if (!index) {
+			WARN_PRINT(vformat("Encoding set for property '%s' which is not replicated.", path));
+			continue;
+		}
+		const Dictionary encoding = property_encodings[keys[i]];
+		const int mode = encoding.get("encoding", PROPERTY_ENCODING_DEFAULT);
+		ERR_CONTINUE_MSG(mode < PROPERTY_ENCODING_DEFAULT || mode > PROPERTY_ENCODING_BITS, vformat("Invalid encoding for property '%s'.", path));
+
+		EncodingProfile &profile = encoding_profiles[*index];
+		profile.mode = EncodingProfile::Mode(mode);
+		profile.min = encoding.get("min", 0.0);
+		profile.max = encoding.get("max", 1.0);
+		profile.bits = CLAMP(int(encoding.get("bits", 0)), 0, 32);
+	}
+}
 
+void SceneSynchronizer::_put_property(StateWriter &r_writer, uint32_t p_index, const Variant &p_value) const {
+	const Variant::Type type = plan_bindings[p_index].type;
+	if (encoding_profiles.is_empty()) {
+		r_writer.put_value(p_value, type);
 	} else {
-		// Watch for changes.
+		r_writer.put_encoded(p_value, type, encoding_profiles[p_index]);
+	}
+}
+
+Variant SceneSynchronizer::_get_property(StateReader &p_reader, uint32_t p_index) const {
+	const Variant::Type type = plan_bindings[p_index].type;
+	if (encoding_profiles.is_empty()) {
+		return p_reader.get_value(type);
+	}
+	return p_reader.get_encoded(type, encoding_profiles[p_index]);
+}
+
+Error SceneSynchronizer::_append_sync_values(Array &r_values) {
+	const ReplicationPlan &p = _get_plan();
+	if (p.sync_indices.is_empty()) {
+		return OK;
+	}
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	for (const uint32_t index : p.sync_indices) {
+		const ReplicationPlan::Property &prop = p.properties[index];
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		Variant result = _get_plan_value(prop, obj);
+		ERR_FAIL_COND_V_MSG(result.get_type() == Variant::NIL, ERR_INVALID_DATA, vformat("Property '%s' not found.", prop.path));
+		r_values.push_back(result);
+	}
+	return OK;
+}
+
+Error SceneSynchronizer::_append_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, Array &r_props, Array &r_values) {
+	if (last_watch_usec != p_cur_usec) {
 		Error err = _watch_changes(p_cur_usec);
-		ERR_FAIL_COND(err != OK);
+		ERR_FAIL_COND_V(err != OK, err);
 		last_watch_usec = p_cur_usec;
 	}
 
-	auto size = watchers.size();
-	r_delta_props.resize(size);
-	r_delta_values.resize(size);
+	for (uint32_t i = 0; i < watchers.size(); i++) {
+		const Watcher &w = watchers[i];
+		if (w.last_change_usec <= p_last_usec) {
+			continue;
+		}
+		r_props.push_back(plan->properties[plan->watch_indices[i]].path);
+		r_values.push_back(w.value);
+	}
+	return OK;
+}
+
+Error SceneSynchronizer::_write_sync_state(StateWriter &r_writer) {
+	const ReplicationPlan &p = _get_plan();
+	if (p.sync_indices.is_empty()) {
+		return OK;
+	}
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	for (const uint32_t index : p.sync_indices) {
+		const ReplicationPlan::Property &prop = p.properties[index];
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		Variant result = _get_plan_value(prop, obj);
+		ERR_FAIL_COND_V_MSG(result.get_type() == Variant::NIL, ERR_INVALID_DATA, vformat("Property '%s' not found.", prop.path));
+		_put_property(r_writer, index, result);
+	}
+	return OK;
+}
+
+// Delta payloads start with a varint header of (changed_count << 1) | has_mask. With the mask bit set, a dirty bitmask
+// over the watch list follows; otherwise each value is preceded by its varint watch index. The smaller form is chosen.
+Error SceneSynchronizer::_write_delta_state(uint64_t p_last_usec, StateWriter &r_writer) {
+	const uint32_t size = watchers.size();
+	uint32_t changed = 0;
+	uint32_t index_bytes = 0;
+	for (uint32_t i = 0; i < size; i++) {
+		if (watchers[i].last_change_usec > p_last_usec) {
+			changed++;
+			index_bytes += i < (1 << 7) ? 1 : (i < (1 << 14) ? 2 : 3);
+		}
+	}
+
+	const uint32_t mask_bytes = (size + 7) / 8;
+	const bool use_mask = changed > 0 && mask_bytes <= index_bytes;
+	r_writer.put_varint((uint64_t(changed) << 1) | (use_mask ? 1 : 0));
+	if (changed == 0) {
+		return OK;
+	}
+
+	_update_encoding_profiles();
+	if (use_mask) {
+		for (uint32_t base = 0; base < size; base += 8) {
+			uint8_t bits = 0;
+			for (uint32_t bit = 0; bit < 8 && base + bit < size; bit++) {
+				if (watchers[base + bit].last_change_usec > p_last_usec) {
+					bits |= 1 << bit;
+				}
+			}
+			r_writer.put_u8(bits);
+		}
+	}
+
+	for (uint32_t i = 0; i < size; i++) {
+		const Watcher &w = watchers[i];
+		if (w.last_change_usec <= p_last_usec) {
+			continue;
+		}
+		if (!use_mask) {
+			r_writer.put_varint(i);
+		}
+		_put_property(r_writer, plan->watch_indices[i], w.value);
+	}
+	return OK;
+}
 
-	const Watcher *ptr = size ? watchers.ptr() : nullptr;
+Error SceneSynchronizer::_read_sync_state(StateReader &p_reader) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	for (const uint32_t index : plan->sync_indices) {
+		const ReplicationPlan::Property &prop = plan->properties[index];
+		Variant value = _get_property(p_reader, index);
+		ERR_FAIL_COND_V_MSG(p_reader.has_failed(), ERR_INVALID_DATA, vformat("Truncated sync state at property '%s'.", prop.path));
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		_set_plan_value(prop, obj, value);
+	}
+	return OK;
+}
+
+Error SceneSynchronizer::_decode_sync_values(StateReader &p_reader, Array &r_values) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	r_values.resize(plan->sync_indices.size());
+	for (uint32_t i = 0; i < plan->sync_indices.size(); i++) {
+		const uint32_t index = plan->sync_indices[i];
+		r_values[i] = _get_property(p_reader, index);
+		ERR_FAIL_COND_V_MSG(p_reader.has_failed(), ERR_INVALID_DATA, vformat("Truncated sync state at property '%s'.", plan->properties[index].path));
+	}
+	return OK;
+}
+
+Error SceneSynchronizer::_read_delta_state(StateReader &p_reader) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	const uint32_t size = plan->watch_indices.size();
+	const uint64_t header = p_reader.get_varint();
+	const uint64_t changed = header >> 1;
+	const uint8_t *mask = (header & 1) ? p_reader.get_bytes((size + 7) / 8) : nullptr;
+	ERR_FAIL_COND_V(p_reader.has_failed() || changed > size, ERR_INVALID_DATA);
+
+	uint64_t watch_index = 0;
+	for (uint64_t i = 0; i < changed; i++) {
+		if (mask) {
+			while (watch_index < size && !(mask[watch_index >> 3] & (1 << (watch_index & 7)))) {
+				watch_index++;
+			}
+		} else {
+			watch_index = p_reader.get_varint();
+		}
+		ERR_FAIL_COND_V(p_reader.has_failed() || watch_index >= size, ERR_INVALID_DATA);
+
+		const uint32_t index = plan->watch_indices[watch_index];
+		const ReplicationPlan::Property &prop = plan->properties[index];
+		Variant value = _get_property(p_reader, index);
+		ERR_FAIL_COND_V_MSG(p_reader.has_failed(), ERR_INVALID_DATA, vformat("Truncated delta state at property '%s'.", prop.path));
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		_set_plan_value(prop, obj, value);
+		watch_index++;
+	}
+	return OK;
+}
+
+PackedByteArray SceneSynchronizer::get_delta_state_compact(uint64_t p_cur_usec, uint64_t p_last_usec, Array r_delta_values) {
+	r_delta_values.clear();
+	if (_update_watchers(p_cur_usec, p_last_usec) != OK) {
+		return PackedByteArray();
+	}
+
+	const uint32_t size = watchers.size();
+	PackedByteArray mask;
+	mask.resize((size + 7) / 8);
+	mask.fill(0);
+	uint8_t *bits = mask.ptrw();
+
+	for (uint32_t i = 0; i < size; i++) {
+		const Watcher &w = watchers[i];
+		if (w.last_change_usec <= p_last_usec) {
+			continue;
+		}
+		bits[i >> 3] |= 1 << (i & 7);
+		r_delta_values.push_back(w.value);
+	}
+	return mask;
+}
+
+Error SceneSynchronizer::set_delta_state_compact(const PackedByteArray &p_delta_mask, const Array &p_delta_values) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	const uint32_t size = plan->watch_indices.size();
+	ERR_FAIL_COND_V(p_delta_mask.size() != int64_t((size + 7) / 8), ERR_INVALID_PARAMETER);
+
+	const uint8_t *bits = p_delta_mask.ptr();
+	int64_t value_index = 0;
+	for (uint32_t i = 0; i < size; i++) {
+		if (!(bits[i >> 3] & (1 << (i & 7)))) {
+			continue;
+		}
+		ERR_FAIL_COND_V(value_index >= p_delta_values.size(), ERR_INVALID_PARAMETER);
+		const ReplicationPlan::Property &prop = plan->properties[plan->watch_indices[i]];
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		_set_plan_value(prop, obj, p_delta_values[value_index++]);
+	}
+	ERR_FAIL_COND_V(value_index != p_delta_values.size(), ERR_INVALID_PARAMETER);
+	return OK;
+}
+
+PackedByteArray SceneSynchronizer::get_sync_state_packed(uint64_t p_cur_usec, uint64_t p_last_usec) {
+	if (p_cur_usec < p_last_usec + sync_interval_usec) {
+		// Too soon skip sync synchronization.
+		return PackedByteArray();
+	}
+
+	StateWriter writer;
+	ERR_FAIL_COND_V(_write_sync_state(writer) != OK, PackedByteArray());
+	return writer.finish();
+}
+
+PackedByteArray SceneSynchronizer::get_delta_state_packed(uint64_t p_cur_usec, uint64_t p_last_usec) {
+	if (_update_watchers(p_cur_usec, p_last_usec) != OK) {
+		return PackedByteArray();
+	}
+
+	StateWriter writer;
+	ERR_FAIL_COND_V(_write_delta_state(p_last_usec, writer) != OK, PackedByteArray());
+	return writer.finish();
+}
+
+Error SceneSynchronizer::set_sync_state_packed(const PackedByteArray &p_state) {
+	StateReader reader(p_state);
+	Error err = _read_sync_state(reader);
+	ERR_FAIL_COND_V(err != OK, err);
+	ERR_FAIL_COND_V_MSG(!reader.is_eof(), ERR_INVALID_DATA, "Trailing bytes after sync state.");
+	return OK;
+}
+
+Error SceneSynchronizer::set_delta_state_packed(const PackedByteArray &p_state) {
+	StateReader reader(p_state);
+	Error err = _read_delta_state(reader);
+	ERR_FAIL_COND_V(err != OK, err);
+	ERR_FAIL_COND_V_MSG(!reader.is_eof(), ERR_INVALID_DATA, "Trailing bytes after delta state.");
+	return OK;
+}
+
+Error SceneSynchronizer::set_sync_state(const Array &p_values) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	ERR_FAIL_COND_V(p_values.size() != plan->sync_indices.size(), ERR_INVALID_PARAMETER);
+	for (uint32_t i = 0; i < plan->sync_indices.size(); i++) {
+		const ReplicationPlan::Property &prop = plan->properties[plan->sync_indices[i]];
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		_set_plan_value(prop, obj, p_values[i]);
+	}
+	return OK;
+}
+
+Error SceneSynchronizer::set_delta_state(const TypedArray<NodePath> &p_delta_props, const Array &p_delta_values) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	ERR_FAIL_COND_V(p_delta_props.size() != p_delta_values.size(), ERR_INVALID_PARAMETER);
+	for (int64_t i = 0; i < p_delta_props.size(); i++) {
+		const NodePath path = p_delta_props[i];
+		if (path.is_empty()) {
+			// Unchanged property.
+			continue;
+		}
+		const uint32_t *index = plan->property_indices.getptr(path);
+		ERR_CONTINUE_MSG(!index, vformat("Property '%s' is not replicated.", path));
+		const ReplicationPlan::Property &prop = plan->properties[*index];
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_CONTINUE(!obj);
+		_set_plan_value(prop, obj, p_delta_values[i]);
+	}
+	return OK;
+}
+
+void SceneSynchronizer::_clear_snapshots() {
+	snapshot_times.clear();
+	snapshot_values.clear();
+	snapshot_stride = 0;
+	snapshot_head = 0;
+	snapshot_count = 0;
+	snapshot_started = false;
+	snapshot_settled = false;
+}
+
+bool SceneSynchronizer::push_sync_snapshot(uint16_t p_network_time, const Array &p_sync_values) {
+	if (!interpolation_enabled) {
+		return set_sync_state(p_sync_values) == OK;
+	}
+	ERR_FAIL_COND_V(!_bind_plan(), false);
+	const uint32_t stride = plan->sync_indices.size();
+	ERR_FAIL_COND_V(p_sync_values.size() != stride, false);
+
+	if (snapshot_stride != stride || snapshot_times.size() != interpolation_buffer_size) {
+		_clear_snapshots();
+		snapshot_stride = stride;
+		snapshot_times.resize(interpolation_buffer_size);
+		snapshot_values.resize(interpolation_buffer_size * stride);
+	}
+
+	// Unwrap the 16-bit network time against the newest snapshot; anything not newer is stale.
+	const int64_t tick = snapshot_started ? snapshot_tick + int16_t(uint16_t(p_network_time - snapshot_network_time)) : int64_t(p_network_time);
+	if (snapshot_started && tick <= snapshot_tick) {
+		return false;
+	}
+	const double time = double(tick) / network_tick_rate;
+	const double now = double(Time::get_singleton()->get_ticks_usec()) / 1000000.0;
+	const double offset = now - time;
+	if (!snapshot_started || Math::abs(offset - clock_offset) > 1.0) {
+		clock_offset = offset;
+	} else {
+		// Smooth out arrival jitter.
+		clock_offset += (offset - clock_offset) * 0.05;
+	}
+	snapshot_started = true;
+	snapshot_tick = tick;
+	snapshot_network_time = p_network_time;
+
+	const uint32_t capacity = snapshot_times.size();
+	const uint32_t slot = (snapshot_head + snapshot_count) % capacity;
+	if (snapshot_count == capacity) {
+		snapshot_head = (snapshot_head + 1) % capacity;
+	} else {
+		snapshot_count++;
+	}
+	snapshot_times[slot] = time;
+	for (uint32_t i = 0; i < stride; i++) {
+		snapshot_values[slot * stride + i] = p_sync_values[i];
+	}
+	snapshot_settled = false;
+	return true;
+}
+
+bool SceneSynchronizer::push_sync_snapshot_packed(uint16_t p_network_time, const PackedByteArray &p_state) {
+	StateReader reader(p_state);
+	Array values;
+	ERR_FAIL_COND_V(_decode_sync_values(reader, values) != OK, false);
+	ERR_FAIL_COND_V_MSG(!reader.is_eof(), false, "Trailing bytes after sync state.");
+	return push_sync_snapshot(p_network_time, values);
+}
+
+int SceneSynchronizer::get_snapshot_count() const {
+	return snapshot_count;
+}
+
+void SceneSynchronizer::_clear_predictions() {
+	prediction_times.clear();
+	prediction_inputs.clear();
+	prediction_values.clear();
+	prediction_stride = 0;
+	prediction_head = 0;
+	prediction_count = 0;
+}
+
+void SceneSynchronizer::_sample_prediction(uint32_t p_slot) {
+	for (uint32_t i = 0; i < prediction_stride; i++) {
+		const ReplicationPlan::Property &prop = plan->properties[plan->sync_indices[i]];
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		prediction_values[p_slot * prediction_stride + i] = obj ? _get_plan_value(prop, obj) : Variant();
+	}
+}
+
+// Records the local state after simulating `p_input` for the tick at `p_network_time`.
+bool SceneSynchronizer::record_prediction(uint16_t p_network_time, const Variant &p_input) {
+	ERR_FAIL_COND_V_MSG(!prediction_enabled, false, "Prediction is not enabled.");
+	ERR_FAIL_COND_V(!_bind_plan(), false);
+	const uint32_t stride = plan->sync_indices.size();
+	if (prediction_stride != stride || prediction_times.size() != prediction_buffer_size) {
+		_clear_predictions();
+		prediction_stride = stride;
+		prediction_times.resize(prediction_buffer_size);
+		prediction_inputs.resize(prediction_buffer_size);
+		prediction_values.resize(prediction_buffer_size * stride);
+	}
+
+	const uint32_t capacity = prediction_times.size();
+	if (prediction_count > 0) {
+		const uint16_t newest = prediction_times[(prediction_head + prediction_count - 1) % capacity];
+		ERR_FAIL_COND_V_MSG(int16_t(uint16_t(p_network_time - newest)) <= 0, false, "Predicted frames must be recorded in network time order.");
+	}
+	const uint32_t slot = (prediction_head + prediction_count) % capacity;
+	if (prediction_count == capacity) {
+		prediction_head = (prediction_head + 1) % capacity;
+	} else {
+		prediction_count++;
+	}
+	prediction_times[slot] = p_network_time;
+	prediction_inputs[slot] = p_input;
+	_sample_prediction(slot);
+	return true;
+}
+
+// Compares an authoritative state against the frame predicted for the same network time. Within the threshold the
+// prediction stands; otherwise the state is applied and every later frame is resimulated through
+// resimulate_callback(network_time, input). Returns true if a misprediction was corrected. With prediction disabled the
+// state is applied as is and nothing is ever mispredicted.
+bool SceneSynchronizer::reconcile_sync_state(uint16_t p_network_time, const Array &p_sync_values) {
+	if (!prediction_enabled) {
+		ERR_FAIL_COND_V(set_sync_state(p_sync_values) != OK, false);
+		return false;
+	}
+	ERR_FAIL_COND_V(!_bind_plan(), false);
+	ERR_FAIL_COND_V(p_sync_values.size() != plan->sync_indices.size(), false);
+
+	// Frames before the authoritative one can no longer be corrected.
+	const uint32_t capacity = prediction_times.size();
+	while (prediction_count > 0 && int16_t(uint16_t(prediction_times[prediction_head] - p_network_time)) < 0) {
+		prediction_inputs[prediction_head] = Variant();
+		prediction_head = (prediction_head + 1) % capacity;
+		prediction_count--;
+	}
+
+	if (prediction_count > 0 && prediction_times[prediction_head] == p_network_time && prediction_stride == uint32_t(p_sync_values.size())) {
+		const uint32_t slot = prediction_head;
+		prediction_inputs[slot] = Variant();
+		prediction_head = (prediction_head + 1) % capacity;
+		prediction_count--;
+
+		bool mispredicted = false;
+		for (uint32_t i = 0; i < prediction_stride && !mispredicted; i++) {
+			mispredicted = _get_value_error(prediction_values[slot * prediction_stride + i], p_sync_values[i]) > prediction_threshold;
+		}
+		if (!mispredicted) {
+			return false;
+		}
+	} else if (prediction_count == 0) {
+		// Nothing pending: the state is simply the newest known one.
+		ERR_FAIL_COND_V(set_sync_state(p_sync_values) != OK, false);
+		return false;
+	}
+
+	ERR_FAIL_COND_V(set_sync_state(p_sync_values) != OK, false);
+	resimulation_count++;
+	if (!resimulate_callback.is_valid()) {
+		WARN_PRINT_ONCE("Misprediction without a resimulate_callback, pending predicted frames are dropped.");
+		_clear_predictions();
+		return true;
+	}
+	for (uint32_t i = 0; i < prediction_count; i++) {
+		const uint32_t slot = (prediction_head + i) % capacity;
+		resimulate_callback.call(prediction_times[slot], prediction_inputs[slot]);
+		_sample_prediction(slot);
+	}
+	return true;
+}
+
+bool SceneSynchronizer::reconcile_sync_state_packed(uint16_t p_network_time, const PackedByteArray &p_state) {
+	StateReader reader(p_state);
+	Array values;
+	ERR_FAIL_COND_V(_decode_sync_values(reader, values) != OK, false);
+	ERR_FAIL_COND_V_MSG(!reader.is_eof(), false, "Trailing bytes after sync state.");
+	return reconcile_sync_state(p_network_time, values);
+}
+
+int SceneSynchronizer::get_prediction_count() const {
+	return prediction_count;
+}
+
+int SceneSynchronizer::get_resimulation_count() const {
+	return resimulation_count;
+}
+
+void SceneSynchronizer::set_history_enabled(bool p_enabled) {
+	history_enabled = p_enabled;
+	history.reset();
+}
+
+bool SceneSynchronizer::is_history_enabled() const {
+	return history_enabled;
+}
+
+void SceneSynchronizer::set_history_size(int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 2, "History must hold at least 2 frames.");
+	history_size = p_size;
+	history.reset();
+}
+
+int SceneSynchronizer::get_history_size() const {
+	return history_size;
+}
+
+bool SceneSynchronizer::_get_root_position(Vector3 &r_position) {
+	Node *root = get_root_node();
+	if (const Node3D *node_3d = Object::cast_to<Node3D>(root)) {
+		r_position = node_3d->get_global_position();
+		return true;
+	}
+	if (const Node2D *node_2d = Object::cast_to<Node2D>(root)) {
+		const Vector2 position = node_2d->get_global_position();
+		r_position = Vector3(position.x, position.y, 0);
+		return true;
+	}
+	return false;
+}
+
+// Samples every sync property and the root position into the history at `p_usec`, which must not go backwards.
+bool SceneSynchronizer::record_history(uint64_t p_usec) {
+	ERR_FAIL_COND_V_MSG(!history_enabled, false, "History is not enabled.");
+	ERR_FAIL_COND_V(!_bind_plan(), false);
+
+	if (!history.is_configured()) {
+		LocalVector<Variant::Type> types;
+		types.resize(plan->sync_indices.size());
+		for (uint32_t i = 0; i < types.size(); i++) {
+			types[i] = plan_bindings[plan->sync_indices[i]].type;
+		}
+		history.configure(types, history_size);
+	}
+
+	Vector3 position;
+	_get_root_position(position);
+	const uint32_t slot = history.record(p_usec, position);
+	for (uint32_t i = 0; i < plan->sync_indices.size(); i++) {
+		const ReplicationPlan::Property &prop = plan->properties[plan->sync_indices[i]];
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		history.set_value(slot, i, obj ? _get_plan_value(prop, obj) : Variant());
+	}
+	return true;
+}
+
+// Sync values as they were at `p_usec`, in sync property order, or an empty array without history.
+Array SceneSynchronizer::get_history_state(uint64_t p_usec) const {
+	Array values;
+	history.sample(p_usec, values);
+	return values;
+}
+
+Vector3 SceneSynchronizer::get_history_position(uint64_t p_usec) const {
+	Vector3 position;
+	history.sample_position(p_usec, position);
+	return position;
+}
+
+int SceneSynchronizer::get_history_count() const {
+	return history.get_count();
+}
+
+Variant SceneSynchronizer::_interpolate(const Variant &p_from, const Variant &p_to, real_t p_weight) {
+	if (p_from.get_type() != p_to.get_type()) {
+		return p_from;
+	}
+	switch (p_from.get_type()) {
+		case Variant::FLOAT:
+			return Math::lerp(double(p_from), double(p_to), double(p_weight));
+		case Variant::VECTOR2:
+			return Vector2(p_from).lerp(p_to, p_weight);
+		case Variant::VECTOR3:
+			return Vector3(p_from).lerp(p_to, p_weight);
+		case Variant::VECTOR4:
+			return Vector4(p_from).lerp(p_to, p_weight);
+		case Variant::QUATERNION:
+			return Quaternion(p_from).slerp(p_to, p_weight);
+		case Variant::BASIS:
+			return Basis(p_from).slerp(p_to, p_weight);
+		case Variant::TRANSFORM2D:
+			return Transform2D(p_from).interpolate_with(p_to, p_weight);
+		case Variant::TRANSFORM3D:
+			return Transform3D(p_from).interpolate_with(p_to, p_weight);
+		case Variant::COLOR:
+			return Color(p_from).lerp(p_to, p_weight);
+		default:
+			// Discrete values switch once the next snapshot is reached.
+			return p_from;
+	}
+}
+
+void SceneSynchronizer::_process_interpolation() {
+	if (snapshot_count == 0 || snapshot_settled || !_bind_plan() || plan->sync_indices.size() != snapshot_stride) {
+		return;
+	}
+
+	const uint32_t capacity = snapshot_times.size();
+	const double now = double(Time::get_singleton()->get_ticks_usec()) / 1000000.0;
+	const double render_time = now - clock_offset - interpolation_delay;
+
+	// Drop snapshots the render time has moved past, keeping the one right before it.
+	while (snapshot_count > 1 && snapshot_times[(snapshot_head + 1) % capacity] <= render_time) {
+		snapshot_head = (snapshot_head + 1) % capacity;
+		snapshot_count--;
+	}
+
+	const uint32_t from = snapshot_head;
+	const bool interpolate = snapshot_count > 1 && render_time > snapshot_times[from];
+	const uint32_t to = interpolate ? (from + 1) % capacity : from;
+	const real_t weight = interpolate ? real_t((render_time - snapshot_times[from]) / (snapshot_times[to] - snapshot_times[from])) : 0;
+
+	for (uint32_t i = 0; i < snapshot_stride; i++) {
+		const ReplicationPlan::Property &prop = plan->properties[plan->sync_indices[i]];
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL(obj);
+		const Variant &value = snapshot_values[from * snapshot_stride + i];
+		_set_plan_value(prop, obj, interpolate ? _interpolate(value, snapshot_values[to * snapshot_stride + i], weight) : value);
+	}
+	// Holding the only snapshot left, nothing changes until the next one arrives.
+	snapshot_settled = snapshot_count == 1;
+}
+
+void SceneSynchronizer::_clear_baselines() {
+	baselines.clear();
+	baseline_head = 0;
+	applied_baseline_id = 0;
+}
+
+const SceneSynchronizer::Baseline *SceneSynchronizer::_find_baseline(uint32_t p_id) const {
+	if (p_id == 0) {
+		return nullptr;
+	}
+	for (const Baseline &baseline : baselines) {
+		if (baseline.id == p_id) {
+			return &baseline;
+		}
+	}
+	return nullptr;
+}
+
+void SceneSynchronizer::_push_baseline(Baseline &&p_baseline) {
+	if (baselines.size() < BASELINE_HISTORY_SIZE) {
+		baselines.push_back(std::move(p_baseline));
+		return;
+	}
+	baselines[baseline_head] = std::move(p_baseline);
+	baseline_head = (baseline_head + 1) % BASELINE_HISTORY_SIZE;
+}
+
+Error SceneSynchronizer::_write_baseline(uint32_t p_id) {
+	const ReplicationPlan &p = _get_plan();
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+
+	StateWriter writer;
+	Baseline baseline;
+	baseline.id = p_id;
+	baseline.offsets.resize(p.properties.size() + 1);
+	for (uint32_t i = 0; i < p.properties.size(); i++) {
+		const ReplicationPlan::Property &prop = p.properties[i];
+		const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		Variant value = _get_plan_value(prop, obj);
+		ERR_FAIL_COND_V_MSG(value.get_type() == Variant::NIL, ERR_INVALID_DATA, vformat("Property '%s' not found.", prop.path));
+		baseline.offsets[i] = writer.get_position();
+		writer.align();
+		_put_property(writer, i, value);
+	}
+	baseline.offsets[p.properties.size()] = writer.get_position();
+	baseline.data = writer.finish();
+	_push_baseline(std::move(baseline));
+	return OK;
+}
+
+// Baseline deltas are a varint baseline id (0 for none), a bitmask over all plan properties of the fields that differ
+// from the baseline, then the changed fields. Returns false when nothing changed since the baseline.
+bool SceneSynchronizer::_write_baseline_delta(uint32_t p_id, uint32_t p_base_id, StateWriter &r_writer) const {
+	const Baseline *current = _find_baseline(p_id);
+	ERR_FAIL_NULL_V(current, false);
+	const uint32_t count = current->offsets.size() - 1;
+	const Baseline *base = _find_baseline(p_base_id);
+	if (base && base->offsets.size() != current->offsets.size()) {
+		base = nullptr;
+	}
+
+	LocalVector<uint8_t> mask;
+	mask.resize((count + 7) / 8);
+	bool changed = false;
+	for (uint32_t i = 0; i < mask.size(); i++) {
+		mask[i] = 0;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t size = current->offsets[i + 1] - current->offsets[i];
+		if (base) {
+			const uint32_t base_size = base->offsets[i + 1] - base->offsets[i];
+			if (size == base_size && memcmp(current->data.ptr() + current->offsets[i], base->data.ptr() + base->offsets[i], size) == 0) {
+				continue;
+			}
+		}
+		mask[i >> 3] |= 1 << (i & 7);
+		changed = true;
+	}
+	if (base && !changed) {
+		return false;
+	}
+
+	r_writer.put_varint(base ? p_base_id : 0);
+	r_writer.put_bytes(mask.ptr(), mask.size());
+	for (uint32_t i = 0; i < count; i++) {
+		if (mask[i >> 3] & (1 << (i & 7))) {
+			r_writer.put_bytes(current->data.ptr() + current->offsets[i], current->offsets[i + 1] - current->offsets[i]);
+		}
+	}
+	return true;
+}
+
+Error SceneSynchronizer::_read_baseline_delta(uint32_t p_id, StateReader &p_reader) {
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_encoding_profiles();
+	const uint32_t count = plan->properties.size();
+
+	const uint64_t base_id = p_reader.get_varint();
+	const uint8_t *mask = p_reader.get_bytes((count + 7) / 8);
+	ERR_FAIL_COND_V(p_reader.has_failed() || base_id > UINT32_MAX, ERR_INVALID_DATA);
+	const Baseline *base = _find_baseline(uint32_t(base_id));
+	ERR_FAIL_COND_V_MSG(base_id != 0 && (!base || base->offsets.size() != count + 1), ERR_DOES_NOT_EXIST, vformat("Missing baseline snapshot %d.", base_id));
+	// Unchanged fields only need applying when the node holds a different state than the baseline.
+	const bool base_applied = base && applied_baseline_id == base_id;
+
+	StateWriter writer;
+	Baseline baseline;
+	baseline.id = p_id;
+	baseline.offsets.resize(count + 1);
+	for (uint32_t i = 0; i < count; i++) {
+		const ReplicationPlan::Property &prop = plan->properties[i];
+		baseline.offsets[i] = writer.get_position();
+
+		Variant value;
+		if (mask[i >> 3] & (1 << (i & 7))) {
+			const int64_t start = p_reader.get_position();
+			p_reader.align();
+			value = _get_property(p_reader, i);
+			ERR_FAIL_COND_V_MSG(p_reader.has_failed(), ERR_INVALID_DATA, vformat("Truncated baseline delta at property '%s'.", prop.path));
+			writer.put_bytes(p_reader.get_data() + start, p_reader.get_position() - start);
+		} else {
+			ERR_FAIL_NULL_V_MSG(base, ERR_INVALID_DATA, "Baseline delta without a baseline must contain every field.");
+			writer.put_bytes(base->data.ptr() + base->offsets[i], base->offsets[i + 1] - base->offsets[i]);
+			if (base_applied) {
+				continue;
+			}
+			StateReader base_reader(base->data);
+			base_reader.skip(base->offsets[i]);
+			value = _get_property(base_reader, i);
+			ERR_FAIL_COND_V(base_reader.has_failed(), ERR_INVALID_DATA);
+		}
+
+		Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+		ERR_FAIL_NULL_V(obj, FAILED);
+		_set_plan_value(prop, obj, value);
+	}
+	baseline.offsets[count] = writer.get_position();
+	baseline.data = writer.finish();
+	_push_baseline(std::move(baseline));
+	applied_baseline_id = p_id;
+	return OK;
+}
+
+void SceneSynchronizer::_clear_watchers() {
+	watchers.clear();
+	dirty_watchers.clear();
+	watchers_primed = false;
+}
+
+void SceneSynchronizer::_sample_watcher(uint32_t p_index, uint64_t p_usec) {
+	const ReplicationPlan::Property &prop = plan->properties[plan->watch_indices[p_index]];
+	const Object *obj = ObjectDB::get_instance(plan_targets[prop.target]);
+	ERR_FAIL_NULL_MSG(obj, vformat("Node not found for property '%s'.", prop.path));
+	Variant v = _get_plan_value(prop, obj);
+	ERR_FAIL_COND_MSG(v.get_type() == Variant::NIL, vformat("Property '%s' not found.", prop.path));
+	Watcher &w = watchers[p_index];
+
+	if (unlikely(!property_extrapolations.is_empty())) {
+		Extrapolation &extrapolation = extrapolations[plan->watch_indices[p_index]];
+		if (extrapolation.model != EXTRAPOLATION_NONE && _is_extrapolatable(v.get_type())) {
+			if (w.sampled && extrapolation.sent.valid && _get_value_error(_predict(extrapolation, extrapolation.sent, p_usec), v) <= extrapolation.threshold) {
+				// The receiver's prediction is still close enough.
+				return;
+			}
+			_set_reference(extrapolation, extrapolation.sent, v, p_usec);
+			_update_watcher(w, v);
+			w.sampled = true;
+			w.last_change_usec = p_usec;
+			return;
+		}
+	}
+
+	if (_update_watcher(w, v) || !w.sampled) {
+		w.sampled = true;
+		w.last_change_usec = p_usec;
+	}
+}
+
+Error SceneSynchronizer::_watch_changes(uint64_t p_usec) {
+	ERR_FAIL_COND_V(replication_config.is_null(), FAILED);
+	const uint32_t count = _get_plan().watch_indices.size();
+
+	if (watchers.size() != count) {
+		watchers.resize(count);
+		watchers_primed = false;
+	}
+	if (count == 0 && !change_stats_enabled) {
+		return OK;
+	}
+	ERR_FAIL_COND_V(!_bind_plan(), FAILED);
+	_update_extrapolations();
+
+	if (watch_mode == WATCH_MODE_DIRTY && watchers_primed) {
+		for (const uint32_t idx : dirty_watchers) {
+			watchers[idx].dirty = false;
+			_sample_watcher(idx, p_usec);
+		}
+	} else {
+		for (uint32_t idx = 0; idx < count; idx++) {
+			watchers[idx].dirty = false;
+			_sample_watcher(idx, p_usec);
+		}
+		watchers_primed = true;
+	}
+	dirty_watchers.clear();
+
+	if (change_stats_enabled) {
+		_record_change_stats(p_usec);
+	}
+	return OK;
+}
+
+void SceneSynchronizer::_record_change_stats(uint64_t p_usec) {
+	const ReplicationPlan &p = *plan;
+	if (change_counts.size() != p.properties.size()) {
+		reset_change_stats();
+		change_counts.resize(p.properties.size());
+		change_probes.resize(p.properties.size());
+		for (uint32_t &changes : change_counts) {
+			changes = 0;
+		}
+	}
+
+	// The first pass only primes the probes, every value differs from an empty one.
+	const bool counting = change_stats_primed;
+	for (uint32_t i = 0; i < p.properties.size(); i++) {
+		const ReplicationPlan::Property &prop = p.properties[i];
+		bool changed = false;
+		if (prop.watch_index >= 0) {
+			const Watcher &w = watchers[prop.watch_index];
+			changed = w.sampled && w.last_change_usec == p_usec;
+		} else if (const Object *obj = ObjectDB::get_instance(plan_targets[prop.target])) {
+			changed = _update_watcher(change_probes[i], _get_plan_value(prop, obj));
+		}
+		if (changed && counting) {
+			change_counts[i]++;
+		}
+	}
+	if (counting) {
+		change_samples++;
+	}
+	change_stats_primed = true;
+}
+
+void SceneSynchronizer::reset_change_stats() {
+	change_counts.clear();
+	change_probes.clear();
+	change_samples = 0;
+	change_stats_primed = false;
+}
+
+// Sums the statistics of every registered synchronizer sharing this one's plan, so a suggestion reflects all instances
+// of the scene rather than whichever one happens to be asked.
+void SceneSynchronizer::_collect_change_stats(LocalVector<uint64_t> &r_changes, uint64_t &r_samples, uint32_t &r_instances) const {
+	r_changes.resize(plan->properties.size());
+	for (uint64_t &changes : r_changes) {
+		changes = 0;
+	}
+	r_samples = 0;
+	r_instances = 0;
+
+	LocalVector<const SceneSynchronizer *> sources;
+	const SceneSynchronizerServer *server = SceneSynchronizerServer::get_singleton();
+	if (server && server_index >= 0) {
+		for (const SceneSynchronizer *synchronizer : server->get_synchronizer_list()) {
+			if (synchronizer->plan == plan) {
+				sources.push_back(synchronizer);
+			}
+		}
+	} else {
+		sources.push_back(this);
+	}
+
+	for (const SceneSynchronizer *source : sources) {
+		if (source->change_counts.size() != r_changes.size() || source->change_samples == 0) {
+			continue;
+		}
+		for (uint32_t i = 0; i < r_changes.size(); i++) {
+			r_changes[i] += source->change_counts[i];
+		}
+		r_samples += source->change_samples;
+		r_instances++;
+	}
+}
+
+// Properties changing on at least hot_change_rate of the passes are best sent in full every sync, those changing on at
+// most cold_change_rate only when they change. Anything in between keeps its configured classification.
+void SceneSynchronizer::_suggest_classification(uint32_t p_index, uint64_t p_changes, uint64_t p_samples, bool &r_sync, bool &r_watch) const {
+	const ReplicationPlan::Property &prop = plan->properties[p_index];
+	r_sync = prop.sync;
+	r_watch = prop.watch;
+	if (p_samples < min_change_samples) {
+		return;
+	}
+	const double rate = double(p_changes) / p_samples;
+	if (rate >= hot_change_rate) {
+		r_sync = true;
+		r_watch = false;
+	} else if (rate <= cold_change_rate) {
+		r_sync = false;
+		r_watch = true;
+	}
+}
+
+// Reports the statistics of every instance sharing this synchronizer's replication config, summed, and the
+// classification they suggest.
+TypedArray<Dictionary> SceneSynchronizer::get_change_report() const {
+	TypedArray<Dictionary> report;
+	if (!plan) {
+		return report;
+	}
+	LocalVector<uint64_t> changes;
+	uint64_t samples = 0;
+	uint32_t instances = 0;
+	_collect_change_stats(changes, samples, instances);
+
+	for (uint32_t i = 0; i < plan->properties.size(); i++) {
+		const ReplicationPlan::Property &prop = plan->properties[i];
+		bool suggested_sync = false;
+		bool suggested_watch = false;
+		_suggest_classification(i, changes[i], samples, suggested_sync, suggested_watch);
+
+		Dictionary entry;
+		entry["property"] = prop.path;
+		entry["sync"] = prop.sync;
+		entry["watch"] = prop.watch;
+		entry["instances"] = instances;
+		entry["samples"] = samples;
+		entry["changes"] = changes[i];
+		entry["change_rate"] = samples > 0 ? double(changes[i]) / samples : 0.0;
+		entry["suggested_sync"] = suggested_sync;
+		entry["suggested_watch"] = suggested_watch;
+		report.push_back(entry);
+	}
+	return report;
+}
+
+// Applies the suggested classification of a get_change_report() result to the replication config, which is shared by
+// every synchronizer using it. The classification determines the packed wire formats, so the server applies its own
+// report and sends it to its peers, which apply that same report rather than one from their local statistics.
+int SceneSynchronizer::apply_classification(const TypedArray<Dictionary> &p_report) {
+	ERR_FAIL_COND_V(replication_config.is_null(), 0);
+	const Ref<SceneReplicationConfig> config = replication_config;
+
+	int applied = 0;
+	for (int64_t i = 0; i < p_report.size(); i++) {
+		const Dictionary entry = p_report[i];
+		const NodePath path = entry.get("property", NodePath());
+		ERR_CONTINUE_MSG(!config->has_property(path), vformat("Property '%s' is not in the replication config.", path));
+		const bool sync = entry.get("suggested_sync", config->property_get_sync(path));
+		const bool watch = entry.get("suggested_watch", config->property_get_watch(path));
+		if (sync == config->property_get_sync(path) && watch == config->property_get_watch(path)) {
+			continue;
+		}
+		config->property_set_sync(path, sync);
+		config->property_set_watch(path, watch);
+		applied++;
+	}
+	if (applied > 0) {
+		config->emit_changed();
+	}
+	return applied;
+}
+
+// Applies the classification suggested by the statistics of every instance sharing the replication config.
+int SceneSynchronizer::apply_suggested_classification() {
+	ERR_FAIL_COND_V(replication_config.is_null() || !plan, 0);
+	return apply_classification(get_change_report());
+}
+
+template <typename T>
+static _FORCE_INLINE_ bool _update_pod_slot(uint8_t *r_slot, const Variant &p_value) {
+	static_assert(sizeof(T) <= sizeof(Transform3D));
+	const T value = p_value;
+	if (memcmp(r_slot, &value, sizeof(T)) == 0) {
+		return false;
+	}
+	memcpy(r_slot, &value, sizeof(T));
+	return true;
+}
+
+static int64_t _get_container_size(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::DICTIONARY:
+			return Dictionary(p_value).size();
+		case Variant::ARRAY:
+			return Array(p_value).size();
+		case Variant::PACKED_BYTE_ARRAY:
+			return PackedByteArray(p_value).size();
+		case Variant::PACKED_INT32_ARRAY:
+			return PackedInt32Array(p_value).size();
+		case Variant::PACKED_INT64_ARRAY:
+			return PackedInt64Array(p_value).size();
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return PackedFloat32Array(p_value).size();
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return PackedFloat64Array(p_value).size();
+		case Variant::PACKED_STRING_ARRAY:
+			return PackedStringArray(p_value).size();
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return PackedVector2Array(p_value).size();
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return PackedVector3Array(p_value).size();
+		case Variant::PACKED_COLOR_ARRAY:
+			return PackedColorArray(p_value).size();
+		case Variant::PACKED_VECTOR4_ARRAY:
+			return PackedVector4Array(p_value).size();
+		default:
+			return 0;
+	}
+}
+
+bool SceneSynchronizer::_update_watcher(Watcher &r_watcher, const Variant &p_value) {
+	const Variant::Type type = p_value.get_type();
+	const bool type_changed = r_watcher.type != type;
+	r_watcher.type = type;
+
+	bool changed;
+	bool container = false;
+	switch (type) {
+		case Variant::BOOL:
+		case Variant::INT:
+			changed = _update_pod_slot<int64_t>(r_watcher.slot, p_value);
+			break;
+		case Variant::FLOAT:
+			changed = _update_pod_slot<double>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR2:
+			changed = _update_pod_slot<Vector2>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR2I:
+			changed = _update_pod_slot<Vector2i>(r_watcher.slot, p_value);
+			break;
+		case Variant::RECT2:
+			changed = _update_pod_slot<Rect2>(r_watcher.slot, p_value);
+			break;
+		case Variant::RECT2I:
+			changed = _update_pod_slot<Rect2i>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR3:
+			changed = _update_pod_slot<Vector3>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR3I:
+			changed = _update_pod_slot<Vector3i>(r_watcher.slot, p_value);
+			break;
+		case Variant::TRANSFORM2D:
+			changed = _update_pod_slot<Transform2D>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR4:
+			changed = _update_pod_slot<Vector4>(r_watcher.slot, p_value);
+			break;
+		case Variant::VECTOR4I:
+			changed = _update_pod_slot<Vector4i>(r_watcher.slot, p_value);
+			break;
+		case Variant::PLANE:
+			changed = _update_pod_slot<Plane>(r_watcher.slot, p_value);
+			break;
+		case Variant::QUATERNION:
+			changed = _update_pod_slot<Quaternion>(r_watcher.slot, p_value);
+			break;
+		case Variant::AABB:
+			changed = _update_pod_slot<AABB>(r_watcher.slot, p_value);
+			break;
+		case Variant::BASIS:
+			changed = _update_pod_slot<Basis>(r_watcher.slot, p_value);
+			break;
+		case Variant::TRANSFORM3D:
+			changed = _update_pod_slot<Transform3D>(r_watcher.slot, p_value);
+			break;
+		case Variant::COLOR:
+			changed = _update_pod_slot<Color>(r_watcher.slot, p_value);
+			break;
+		case Variant::OBJECT: {
+			const Object *obj = p_value.get_validated_object();
+			const uint64_t id = obj ? obj->get_instance_id() : 0;
+			changed = memcmp(r_watcher.slot, &id, sizeof(id)) != 0;
+			memcpy(r_watcher.slot, &id, sizeof(id));
+		} break;
+		case Variant::DICTIONARY:
+		case Variant::ARRAY:
+		case Variant::PACKED_BYTE_ARRAY:
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::PACKED_VECTOR2_ARRAY:
+		case Variant::PACKED_VECTOR3_ARRAY:
+		case Variant::PACKED_COLOR_ARRAY:
+		case Variant::PACKED_VECTOR4_ARRAY: {
+			// Containers are compared by a 64-bit fingerprint, the element count above the recursive hash, instead of
+			// against a retained copy. Resizes are always caught; a same-size edit is missed only on a 32-bit hash
+			// collision, which is accepted. The copy is only taken to be sent, when the fingerprint moves.
+			const uint64_t fingerprint = (uint64_t(_get_container_size(p_value)) << 32) | p_value.recursive_hash(0);
+			changed = memcmp(r_watcher.slot, &fingerprint, sizeof(fingerprint)) != 0;
+			memcpy(r_watcher.slot, &fingerprint, sizeof(fingerprint));
+			container = true;
+		} break;
+		default:
+			changed = !r_watcher.value.hash_compare(p_value);
+			break;
+	}
+
+	if (changed || type_changed) {
+		r_watcher.value = container ? p_value.duplicate(true) : p_value;
+		return true;
+	}
+	return false;
+}
+
+void SceneSynchronizer::get_sync_state(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_sync_props, Array r_sync_values) {
+	if (p_cur_usec < p_last_usec + sync_interval_usec) {
+		// Too soon skip sync synchronization.
+		return;
+	}
+
+	const ReplicationPlan &p = _get_plan();
+	const uint32_t count = p.sync_indices.size();
+	r_sync_props.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		r_sync_props[i] = p.sync_properties[i];
+	}
+
+	r_sync_values.clear();
+	_append_sync_values(r_sync_values);
+}
+
+void SceneSynchronizer::get_sync_state_encoded(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_sync_props, TypedArray<PackedByteArray> r_sync_values_encoded) {
+	Array sync_values;
+	SceneSynchronizer::get_sync_state(p_cur_usec, p_last_usec, r_sync_props, sync_values);
+
+	r_sync_values_encoded.resize(sync_values.size());
+	for (int i = 0; i < sync_values.size(); i++) {
+		r_sync_values_encoded[i] = UtilityFunctions::var_to_bytes(sync_values[i]);
+	}
+}
+
+uint64_t SceneSynchronizer::_get_last_change_usec() const {
+	uint64_t last_change_usec = 0;
+	for (const Watcher &w : watchers) {
+		last_change_usec = MAX(last_change_usec, w.last_change_usec);
+	}
+	return last_change_usec;
+}
+
+Error SceneSynchronizer::_update_watchers(uint64_t p_cur_usec, uint64_t p_last_usec) {
+	if (last_watch_usec == p_cur_usec) {
+		// We already watched for changes in this frame.
+		return OK;
+	}
+	if (p_cur_usec < p_last_usec + delta_interval_usec) {
+		// Too soon skip delta synchronization.
+		return ERR_SKIP;
+	}
+
+	// Watch for changes.
+	Error err = _watch_changes(p_cur_usec);
+	ERR_FAIL_COND_V(err != OK, err);
+	last_watch_usec = p_cur_usec;
+	return OK;
+}
+
+void SceneSynchronizer::get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_delta_props, Array r_delta_values) {
+	if (_update_watchers(p_cur_usec, p_last_usec) != OK) {
+		return;
+	}
+
+	const uint32_t size = watchers.size();
+	r_delta_props.resize(size);
+	r_delta_values.resize(size);
 
-	for (int i = 0; i < size; i++) {
-		const Watcher &w = ptr[i];
+	for (uint32_t i = 0; i < size; i++) {
+		const Watcher &w = watchers[i];
 		if (w.last_change_usec <= p_last_usec) {
 			continue;
 		}
-		r_delta_props[i] = w.prop;
+		r_delta_props[i] = plan->properties[plan->watch_indices[i]].path;
 		r_delta_values[i] = w.value;
 	}
 }
 
 void SceneSynchronizer::get_delta_state_encoded(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_delta_props, TypedArray<PackedByteArray> r_delta_values_encoded) {
-	TypedArray<NodePath> delta_values;
+	Array delta_values;
 	SceneSynchronizer::get_delta_state(p_cur_usec, p_last_usec, r_delta_props, delta_values);
 
 	r_delta_values_encoded.resize(delta_values.size());
@@ -455,12 +2262,12 @@ void SceneSynchronizer::get_delta_state_encoded(uint64_t p_cur_usec, uint64_t p_
 
 TypedArray<NodePath> SceneSynchronizer::get_delta_properties() {
 	ERR_FAIL_COND_V(replication_config.is_null(), TypedArray<NodePath>());
-	return _get_watch_properties();
+	return _get_plan().watch_properties.duplicate();
 }
 
 TypedArray<NodePath> SceneSynchronizer::get_sync_properties() {
 	ERR_FAIL_COND_V(replication_config.is_null(), TypedArray<NodePath>());
-	return _get_sync_properties();
+	return _get_plan().sync_properties.duplicate();
 }
 
 SceneReplicationConfig *SceneSynchronizer::get_replication_config_ptr() const {
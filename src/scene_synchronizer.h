@@ -1,5 +1,10 @@
 #pragma once
 
+#include "native_accessor.h"
+#include "replication_plan.h"
+#include "state_codec.h"
+#include "state_history.h"
+
 #include <godot_cpp/core/binder_common.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
@@ -11,7 +16,11 @@
 #include <godot_cpp/classes/scene_replication_config.hpp>
 #include <godot_cpp/classes/wrapped.hpp>
 
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 namespace godot {
@@ -19,11 +28,51 @@ namespace godot {
 class SceneSynchronizer : public Node {
 	GDCLASS(SceneSynchronizer, Node);
 
+	friend class SceneSynchronizerServer;
+	friend class TransformChannel;
+
+public:
+	enum WatchMode {
+		// Every watched property is polled each delta interval.
+		WATCH_MODE_POLL,
+		// Only properties flagged through mark_dirty() are sampled, after an initial full poll.
+		WATCH_MODE_DIRTY,
+	};
+
+	enum PropertyEncoding {
+		PROPERTY_ENCODING_DEFAULT = EncodingProfile::DEFAULT,
+		PROPERTY_ENCODING_FIXED_POINT = EncodingProfile::FIXED_POINT,
+		PROPERTY_ENCODING_HALF_FLOAT = EncodingProfile::HALF_FLOAT,
+		PROPERTY_ENCODING_SMALLEST_THREE = EncodingProfile::SMALLEST_THREE,
+		PROPERTY_ENCODING_BITS = EncodingProfile::BITS,
+	};
+
+	enum ExtrapolationModel {
+		EXTRAPOLATION_NONE,
+		// Continues at the rate between the last two values that were sent.
+		EXTRAPOLATION_LINEAR,
+		// Continues at the current value of another replicated property, e.g. position from velocity.
+		EXTRAPOLATION_VELOCITY,
+	};
+
 private:
+	// Field-wise encoding of every replicated property at one snapshot, used as a delta baseline. Each field is
+	// byte-aligned so fields can be compared and copied independently.
+	struct Baseline {
+		uint32_t id = 0;
+		PackedByteArray data;
+		LocalVector<uint32_t> offsets;
+	};
+	static constexpr uint32_t BASELINE_HISTORY_SIZE = 32;
+
 	struct Watcher {
-		NodePath prop;
 		uint64_t last_change_usec = 0;
 		Variant value;
+		// Typed copy of scalar and math values, or the fingerprint of containers, so polling compares raw memory.
+		alignas(8) uint8_t slot[sizeof(Transform3D)] = {};
+		Variant::Type type = Variant::NIL;
+		bool sampled = false;
+		bool dirty = false;
 	};
 
 	Ref<SceneReplicationConfig> replication_config;
@@ -31,14 +80,110 @@ private:
 	MultiplayerSynchronizer *multiplayer_synchronizer = nullptr;
 	uint64_t sync_interval_usec = 0;
 	uint64_t delta_interval_usec = 0;
-	Vector<Watcher> watchers;
+	float replication_priority = 1.0;
+	LocalVector<Watcher> watchers;
+	WatchMode watch_mode = WATCH_MODE_POLL;
+	LocalVector<uint32_t> dirty_watchers;
+	bool watchers_primed = false;
+	// Per plan property change counts over `change_samples` watch passes, used to suggest a sync/watch classification.
+	// Watched properties are counted from their watchers, the others are sampled through probes.
+	bool change_stats_enabled = false;
+	bool change_stats_primed = false;
+	uint32_t change_samples = 0;
+	LocalVector<uint32_t> change_counts;
+	LocalVector<Watcher> change_probes;
+	double hot_change_rate = 0.5;
+	double cold_change_rate = 0.05;
+	uint32_t min_change_samples = 30;
+	std::shared_ptr<const ReplicationPlan> plan;
+	LocalVector<ObjectID> plan_targets;
+	// Per plan property data resolved from this instance's targets whenever they are bound.
+	struct PlanBinding {
+		// NIL means the type is dynamic and is tagged on the wire.
+		Variant::Type type = Variant::NIL;
+		// Typed engine accessor. component is the vector index addressed by a two-level path such as position:x, or -1
+		// for the whole value.
+		NativeAccessor::Type accessor = NativeAccessor::NONE;
+		int8_t component = -1;
+	};
+	LocalVector<PlanBinding> plan_bindings;
+	bool plan_bound = false;
 	uint64_t last_watch_usec = 0;
+	// Property path -> { "encoding", "min", "max", "bits" }, compiled against the plan into encoding_profiles.
+	Dictionary property_encodings;
+	LocalVector<EncodingProfile> encoding_profiles;
+	bool encoding_profiles_dirty = true;
+
+	// Dead reckoning of one property. Both ends extrapolate from the last value that crossed the wire: the sender only
+	// reports a change once that prediction is off by more than the threshold, and the receiver moves the property
+	// along the same prediction in between.
+	struct Extrapolation {
+		struct Reference {
+			Variant value;
+			Variant rate;
+			uint64_t usec = 0;
+			bool valid = false;
+		};
+
+		ExtrapolationModel model = EXTRAPOLATION_NONE;
+		double threshold = 0.0;
+		int32_t velocity_index = -1;
+		Reference sent;
+		Reference received;
+	};
+
+	// Property path -> { "model", "threshold", "velocity" }, compiled against the plan into extrapolations.
+	Dictionary property_extrapolations;
+	LocalVector<Extrapolation> extrapolations;
+	bool extrapolations_dirty = true;
 
 	ObjectID root_node_cache;
 	uint64_t last_sync_usec = 0;
 	uint16_t last_inbound_sync = 0;
 	uint32_t net_id = 0;
 	bool sync_started = false;
+	bool transform_channel_enabled = false;
+	int32_t server_index = -1;
+
+	// Inbound sync snapshots for interpolation: a ring of `interpolation_buffer_size` entries, each holding the values
+	// of every sync property, keyed by unwrapped network time converted to seconds.
+	bool interpolation_enabled = false;
+	double interpolation_delay = 0.1;
+	double network_tick_rate = 60.0;
+	uint32_t interpolation_buffer_size = 32;
+	LocalVector<double> snapshot_times;
+	LocalVector<Variant> snapshot_values;
+	uint32_t snapshot_stride = 0;
+	uint32_t snapshot_head = 0;
+	uint32_t snapshot_count = 0;
+	int64_t snapshot_tick = 0;
+	uint16_t snapshot_network_time = 0;
+	bool snapshot_started = false;
+	bool snapshot_settled = false;
+	double clock_offset = 0.0;
+
+	// Client-side prediction: a ring of `prediction_buffer_size` locally simulated frames, each holding the input that
+	// produced it and the resulting values of every sync property, keyed by network time.
+	bool prediction_enabled = false;
+	double prediction_threshold = 0.01;
+	uint32_t prediction_buffer_size = 64;
+	Callable resimulate_callback;
+	LocalVector<uint16_t> prediction_times;
+	LocalVector<Variant> prediction_inputs;
+	LocalVector<Variant> prediction_values;
+	uint32_t prediction_stride = 0;
+	uint32_t prediction_head = 0;
+	uint32_t prediction_count = 0;
+	uint32_t resimulation_count = 0;
+
+	// Lag compensation: the last `history_size` sync states recorded through record_history().
+	bool history_enabled = false;
+	uint32_t history_size = 64;
+	StateHistory history;
+
+	LocalVector<Baseline> baselines;
+	uint32_t baseline_head = 0;
+	uint32_t applied_baseline_id = 0;
 
 	static Object *_get_prop_target(Object *p_obj, const NodePath &p_prop);
 	static Vector<StringName> _get_subnames(const NodePath &p_path);
@@ -48,11 +193,53 @@ private:
 	void _stop();
 	void _update_process();
 	Error _watch_changes(uint64_t p_usec);
-	TypedArray<NodePath> _get_sync_properties();
-	TypedArray<NodePath> _get_watch_properties();
+	void _sample_watcher(uint32_t p_index, uint64_t p_usec);
+	void _clear_watchers();
+	void _record_change_stats(uint64_t p_usec);
+	void _collect_change_stats(LocalVector<uint64_t> &r_changes, uint64_t &r_samples, uint32_t &r_instances) const;
+	void _suggest_classification(uint32_t p_index, uint64_t p_changes, uint64_t p_samples, bool &r_sync, bool &r_watch) const;
+	static bool _update_watcher(Watcher &r_watcher, const Variant &p_value);
+	void _invalidate_plan();
+	void _unbind_plan();
+	void _on_replication_config_changed();
+	const ReplicationPlan &_get_plan();
+	bool _bind_plan();
+	void _resolve_plan_types();
+	Variant _get_plan_value(const ReplicationPlan::Property &p_prop, const Object *p_obj) const;
+	void _set_plan_value(const ReplicationPlan::Property &p_prop, Object *p_obj, const Variant &p_value);
+	void _write_plan_value(const ReplicationPlan::Property &p_prop, Object *p_obj, const Variant &p_value);
+	void _update_extrapolations();
+	Variant _predict(const Extrapolation &p_extrapolation, const Extrapolation::Reference &p_reference, uint64_t p_usec);
+	static void _set_reference(const Extrapolation &p_extrapolation, Extrapolation::Reference &r_reference, const Variant &p_value, uint64_t p_usec);
+	void _process_extrapolation();
+	void _update_encoding_profiles();
+	void _put_property(StateWriter &r_writer, uint32_t p_index, const Variant &p_value) const;
+	Variant _get_property(StateReader &p_reader, uint32_t p_index) const;
+	uint64_t _get_last_change_usec() const;
+	Error _update_watchers(uint64_t p_cur_usec, uint64_t p_last_usec);
+	Error _append_sync_values(Array &r_values);
+	Error _append_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, Array &r_props, Array &r_values);
+	Error _write_sync_state(StateWriter &r_writer);
+	Error _write_delta_state(uint64_t p_last_usec, StateWriter &r_writer);
+	Error _read_sync_state(StateReader &p_reader);
+	Error _decode_sync_values(StateReader &p_reader, Array &r_values);
+	void _clear_snapshots();
+	void _clear_predictions();
+	void _sample_prediction(uint32_t p_slot);
+	bool _get_root_position(Vector3 &r_position);
+	void _clear_baselines();
+	const Baseline *_find_baseline(uint32_t p_id) const;
+	void _push_baseline(Baseline &&p_baseline);
+	Error _write_baseline(uint32_t p_id);
+	bool _write_baseline_delta(uint32_t p_id, uint32_t p_base_id, StateWriter &r_writer) const;
+	Error _read_baseline_delta(uint32_t p_id, StateReader &p_reader);
+	void _process_interpolation();
+	static Variant _interpolate(const Variant &p_from, const Variant &p_to, real_t p_weight);
+	Error _read_delta_state(StateReader &p_reader);
 
 protected:
 	static void _bind_methods();
+	void _notification(int p_what);
 
 public:
 	static Variant get_state(const TypedArray<NodePath> &p_properties, Object *p_obj, Array r_values);
@@ -82,6 +269,75 @@ public:
 	void set_root_path(const NodePath &p_path);
 	NodePath get_root_path() const;
 
+	void set_watch_mode(WatchMode p_mode);
+	WatchMode get_watch_mode() const;
+	void mark_dirty(const NodePath &p_property);
+	void mark_dirty_index(int p_watch_index);
+	void mark_all_dirty();
+
+	void set_replication_priority(float p_priority);
+	float get_replication_priority() const;
+
+	void set_change_stats_enabled(bool p_enabled);
+	bool is_change_stats_enabled() const;
+	void set_hot_change_rate(double p_rate);
+	double get_hot_change_rate() const;
+	void set_cold_change_rate(double p_rate);
+	double get_cold_change_rate() const;
+	void set_min_change_samples(int p_samples);
+	int get_min_change_samples() const;
+	void reset_change_stats();
+	TypedArray<Dictionary> get_change_report() const;
+	int apply_classification(const TypedArray<Dictionary> &p_report);
+	int apply_suggested_classification();
+
+	void set_interpolation_enabled(bool p_enabled);
+	bool is_interpolation_enabled() const;
+
+	void set_interpolation_delay(double p_delay);
+	double get_interpolation_delay() const;
+
+	void set_network_tick_rate(double p_rate);
+	double get_network_tick_rate() const;
+
+	void set_interpolation_buffer_size(int p_size);
+	int get_interpolation_buffer_size() const;
+
+	bool push_sync_snapshot(uint16_t p_network_time, const Array &p_sync_values);
+	bool push_sync_snapshot_packed(uint16_t p_network_time, const PackedByteArray &p_state);
+	int get_snapshot_count() const;
+
+	void set_prediction_enabled(bool p_enabled);
+	bool is_prediction_enabled() const;
+	void set_prediction_threshold(double p_threshold);
+	double get_prediction_threshold() const;
+	void set_prediction_buffer_size(int p_size);
+	int get_prediction_buffer_size() const;
+	void set_resimulate_callback(const Callable &p_callback);
+	Callable get_resimulate_callback() const;
+	bool record_prediction(uint16_t p_network_time, const Variant &p_input);
+	bool reconcile_sync_state(uint16_t p_network_time, const Array &p_sync_values);
+	bool reconcile_sync_state_packed(uint16_t p_network_time, const PackedByteArray &p_state);
+	int get_prediction_count() const;
+	int get_resimulation_count() const;
+
+	void set_history_enabled(bool p_enabled);
+	bool is_history_enabled() const;
+	void set_history_size(int p_size);
+	int get_history_size() const;
+	bool record_history(uint64_t p_usec);
+	Array get_history_state(uint64_t p_usec) const;
+	Vector3 get_history_position(uint64_t p_usec) const;
+	int get_history_count() const;
+
+	void set_property_extrapolations(const Dictionary &p_extrapolations);
+	Dictionary get_property_extrapolations() const;
+	void set_property_extrapolation(const NodePath &p_property, ExtrapolationModel p_model, double p_threshold, const NodePath &p_velocity_property = NodePath());
+	void clear_property_extrapolation(const NodePath &p_property);
+
+	void set_transform_channel_enabled(bool p_enabled);
+	bool is_transform_channel_enabled() const;
+
 	void set_multiplayer_synchronizer(MultiplayerSynchronizer *p_synchronizer);
 	MultiplayerSynchronizer *get_multiplayer_synchronizer() const;
 
@@ -91,6 +347,22 @@ public:
 	void get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_delta_props, Array r_delta_values);
 	void get_delta_state_encoded(uint64_t p_cur_usec, uint64_t p_last_usec, TypedArray<NodePath> r_delta_props, TypedArray<PackedByteArray> r_delta_values_encoded);
 
+	PackedByteArray get_delta_state_compact(uint64_t p_cur_usec, uint64_t p_last_usec, Array r_delta_values);
+	Error set_delta_state_compact(const PackedByteArray &p_delta_mask, const Array &p_delta_values);
+
+	PackedByteArray get_sync_state_packed(uint64_t p_cur_usec, uint64_t p_last_usec);
+	PackedByteArray get_delta_state_packed(uint64_t p_cur_usec, uint64_t p_last_usec);
+	Error set_sync_state_packed(const PackedByteArray &p_state);
+	Error set_delta_state_packed(const PackedByteArray &p_state);
+
+	Error set_sync_state(const Array &p_values);
+	Error set_delta_state(const TypedArray<NodePath> &p_delta_props, const Array &p_delta_values);
+
+	void set_property_encodings(const Dictionary &p_encodings);
+	Dictionary get_property_encodings() const;
+	void set_property_encoding(const NodePath &p_property, PropertyEncoding p_encoding, double p_min = 0.0, double p_max = 1.0, int p_bits = 0);
+	void clear_property_encoding(const NodePath &p_property);
+
 	TypedArray<NodePath> get_delta_properties();
 	TypedArray<NodePath> get_sync_properties();
 
@@ -100,3 +372,7 @@ public:
 };
 
 } //namespace godot
+
+VARIANT_ENUM_CAST(SceneSynchronizer::WatchMode);
+VARIANT_ENUM_CAST(SceneSynchronizer::PropertyEncoding);
+VARIANT_ENUM_CAST(SceneSynchronizer::ExtrapolationModel);
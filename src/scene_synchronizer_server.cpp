@@ -0,0 +1,987 @@
+#include "scene_synchronizer_server.h"
+
+#include "scene_synchronizer.h"
+
+using namespace godot;
+
+SceneSynchronizerServer *SceneSynchronizerServer::singleton = nullptr;
+
+SceneSynchronizerServer *SceneSynchronizerServer::get_singleton() {
+	return singleton;
+}
+
+void SceneSynchronizerServer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_phase_staggering", "enabled"), &SceneSynchronizerServer::set_phase_staggering);
+	ClassDB::bind_method(D_METHOD("is_phase_staggering"), &SceneSynchronizerServer::is_phase_staggering);
+	ClassDB::bind_method(D_METHOD("get_due_count", "cur_usec", "delta"), &SceneSynchronizerServer::get_due_count, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_due_histogram", "cur_usec", "frame_usec", "frames", "delta"), &SceneSynchronizerServer::get_due_histogram, DEFVAL(false));
+
+	ClassDB::bind_method(D_METHOD("get_synchronizer_count"), &SceneSynchronizerServer::get_synchronizer_count);
+	ClassDB::bind_method(D_METHOD("get_synchronizers"), &SceneSynchronizerServer::get_synchronizers);
+	ClassDB::bind_method(D_METHOD("get_synchronizer_by_net_id", "net_id"), &SceneSynchronizerServer::get_synchronizer_by_net_id);
+
+	ClassDB::bind_method(D_METHOD("gather_sync_states", "cur_usec", "synchronizers", "offsets", "sync_values"), &SceneSynchronizerServer::gather_sync_states);
+	ClassDB::bind_method(D_METHOD("gather_delta_states", "cur_usec", "synchronizers", "offsets", "delta_props", "delta_values"), &SceneSynchronizerServer::gather_delta_states);
+
+	ClassDB::bind_method(D_METHOD("gather_sync_states_packed", "cur_usec"), &SceneSynchronizerServer::gather_sync_states_packed);
+	ClassDB::bind_method(D_METHOD("gather_delta_states_packed", "cur_usec"), &SceneSynchronizerServer::gather_delta_states_packed);
+	ClassDB::bind_method(D_METHOD("apply_batch", "batch", "delta"), &SceneSynchronizerServer::apply_batch, DEFVAL(false));
+
+	ClassDB::bind_method(D_METHOD("set_interest_cell_size", "size"), &SceneSynchronizerServer::set_interest_cell_size);
+	ClassDB::bind_method(D_METHOD("get_interest_cell_size"), &SceneSynchronizerServer::get_interest_cell_size);
+	ClassDB::bind_method(D_METHOD("set_half_rate_distance", "distance"), &SceneSynchronizerServer::set_half_rate_distance);
+	ClassDB::bind_method(D_METHOD("get_half_rate_distance"), &SceneSynchronizerServer::get_half_rate_distance);
+	ClassDB::bind_method(D_METHOD("set_quarter_rate_distance", "distance"), &SceneSynchronizerServer::set_quarter_rate_distance);
+	ClassDB::bind_method(D_METHOD("get_quarter_rate_distance"), &SceneSynchronizerServer::get_quarter_rate_distance);
+	ClassDB::bind_method(D_METHOD("set_rate_tier_callback", "callback"), &SceneSynchronizerServer::set_rate_tier_callback);
+	ClassDB::bind_method(D_METHOD("get_rate_tier_callback"), &SceneSynchronizerServer::get_rate_tier_callback);
+	ClassDB::bind_method(D_METHOD("get_rate_tier", "peer_id", "synchronizer"), &SceneSynchronizerServer::get_rate_tier);
+	ClassDB::bind_method(D_METHOD("set_interest_peer", "peer_id", "origin", "radius"), &SceneSynchronizerServer::set_interest_peer);
+	ClassDB::bind_method(D_METHOD("set_interest_peer_filter", "peer_id", "filter"), &SceneSynchronizerServer::set_interest_peer_filter);
+	ClassDB::bind_method(D_METHOD("remove_interest_peer", "peer_id"), &SceneSynchronizerServer::remove_interest_peer);
+	ClassDB::bind_method(D_METHOD("update_interest"), &SceneSynchronizerServer::update_interest);
+	ClassDB::bind_method(D_METHOD("get_relevant_synchronizers", "peer_id"), &SceneSynchronizerServer::get_relevant_synchronizers);
+	ClassDB::bind_method(D_METHOD("get_entered_synchronizers", "peer_id"), &SceneSynchronizerServer::get_entered_synchronizers);
+	ClassDB::bind_method(D_METHOD("get_exited_synchronizers", "peer_id"), &SceneSynchronizerServer::get_exited_synchronizers);
+	ClassDB::bind_method(D_METHOD("gather_sync_states_for_peers", "cur_usec"), &SceneSynchronizerServer::gather_sync_states_for_peers);
+	ClassDB::bind_method(D_METHOD("gather_delta_states_for_peers", "cur_usec"), &SceneSynchronizerServer::gather_delta_states_for_peers);
+
+	ClassDB::bind_method(D_METHOD("set_peer_bandwidth_budget", "peer_id", "bytes"), &SceneSynchronizerServer::set_peer_bandwidth_budget);
+	ClassDB::bind_method(D_METHOD("get_peer_bandwidth_budget", "peer_id"), &SceneSynchronizerServer::get_peer_bandwidth_budget);
+	ClassDB::bind_method(D_METHOD("remove_peer_bandwidth_budget", "peer_id"), &SceneSynchronizerServer::remove_peer_bandwidth_budget);
+	ClassDB::bind_method(D_METHOD("gather_sync_states_budgeted", "cur_usec"), &SceneSynchronizerServer::gather_sync_states_budgeted);
+	ClassDB::bind_method(D_METHOD("gather_delta_states_budgeted", "cur_usec"), &SceneSynchronizerServer::gather_delta_states_budgeted);
+
+	ClassDB::bind_method(D_METHOD("add_baseline_peer", "peer_id"), &SceneSynchronizerServer::add_baseline_peer);
+	ClassDB::bind_method(D_METHOD("remove_baseline_peer", "peer_id"), &SceneSynchronizerServer::remove_baseline_peer);
+	ClassDB::bind_method(D_METHOD("acknowledge_snapshot", "peer_id", "snapshot_id"), &SceneSynchronizerServer::acknowledge_snapshot);
+	ClassDB::bind_method(D_METHOD("reset_peer_baseline", "peer_id", "net_id"), &SceneSynchronizerServer::reset_peer_baseline);
+	ClassDB::bind_method(D_METHOD("gather_baseline_states", "cur_usec"), &SceneSynchronizerServer::gather_baseline_states);
+	ClassDB::bind_method(D_METHOD("apply_baseline_states", "packet", "failed_net_ids"), &SceneSynchronizerServer::apply_baseline_states, DEFVAL(Array()));
+
+	ClassDB::bind_method(D_METHOD("set_packet_mtu", "mtu"), &SceneSynchronizerServer::set_packet_mtu);
+	ClassDB::bind_method(D_METHOD("get_packet_mtu"), &SceneSynchronizerServer::get_packet_mtu);
+	ClassDB::bind_method(D_METHOD("gather_sync_packets", "cur_usec"), &SceneSynchronizerServer::gather_sync_packets);
+	ClassDB::bind_method(D_METHOD("gather_delta_packets", "cur_usec"), &SceneSynchronizerServer::gather_delta_packets);
+	ClassDB::bind_method(D_METHOD("receive_packet", "peer_id", "packet"), &SceneSynchronizerServer::receive_packet);
+	ClassDB::bind_method(D_METHOD("remove_packet_peer", "peer_id"), &SceneSynchronizerServer::remove_packet_peer);
+
+	ClassDB::bind_method(D_METHOD("set_transform_position_step", "step"), &SceneSynchronizerServer::set_transform_position_step);
+	ClassDB::bind_method(D_METHOD("get_transform_position_step"), &SceneSynchronizerServer::get_transform_position_step);
+	ClassDB::bind_method(D_METHOD("set_transform_refresh_interval", "interval"), &SceneSynchronizerServer::set_transform_refresh_interval);
+	ClassDB::bind_method(D_METHOD("get_transform_refresh_interval"), &SceneSynchronizerServer::get_transform_refresh_interval);
+	ClassDB::bind_method(D_METHOD("reset_transform_baseline"), &SceneSynchronizerServer::reset_transform_baseline);
+	ClassDB::bind_method(D_METHOD("gather_transforms_packed"), &SceneSynchronizerServer::gather_transforms_packed);
+	ClassDB::bind_method(D_METHOD("apply_transforms_packed", "packet"), &SceneSynchronizerServer::apply_transforms_packed);
+
+	ClassDB::bind_method(D_METHOD("record_history", "cur_usec"), &SceneSynchronizerServer::record_history);
+	ClassDB::bind_method(D_METHOD("get_state_at", "net_id", "usec"), &SceneSynchronizerServer::get_state_at);
+	ClassDB::bind_method(D_METHOD("rewind_within_radius", "origin", "radius", "usec"), &SceneSynchronizerServer::rewind_within_radius);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "phase_staggering"), "set_phase_staggering", "is_phase_staggering");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "interest_cell_size", PROPERTY_HINT_RANGE, "1,1024,0.1,or_greater"), "set_interest_cell_size", "get_interest_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "half_rate_distance", PROPERTY_HINT_RANGE, "0,4096,0.1,or_greater"), "set_half_rate_distance", "get_half_rate_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "quarter_rate_distance", PROPERTY_HINT_RANGE, "0,4096,0.1,or_greater"), "set_quarter_rate_distance", "get_quarter_rate_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::CALLABLE, "rate_tier_callback"), "set_rate_tier_callback", "get_rate_tier_callback");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "packet_mtu", PROPERTY_HINT_RANGE, "64,65507,1"), "set_packet_mtu", "get_packet_mtu");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "transform_position_step", PROPERTY_HINT_RANGE, "0.0001,1,0.0001,or_greater"), "set_transform_position_step", "get_transform_position_step");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "transform_refresh_interval", PROPERTY_HINT_RANGE, "0,3600,1,or_greater"), "set_transform_refresh_interval", "get_transform_refresh_interval");
+
+	BIND_ENUM_CONSTANT(RATE_TIER_FULL);
+	BIND_ENUM_CONSTANT(RATE_TIER_HALF);
+	BIND_ENUM_CONSTANT(RATE_TIER_QUARTER);
+}
+
+void SceneSynchronizerServer::register_synchronizer(SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_NULL(p_synchronizer);
+	ERR_FAIL_COND_MSG(p_synchronizer->server_index >= 0, "SceneSynchronizer is already registered.");
+
+	p_synchronizer->server_index = synchronizers.size();
+	synchronizers.push_back(p_synchronizer);
+	sync_intervals.push_back(p_synchronizer->sync_interval_usec);
+	delta_intervals.push_back(p_synchronizer->delta_interval_usec);
+	last_sync_usec.push_back(0);
+	last_delta_usec.push_back(0);
+	phases.push_back(_assign_phase(p_synchronizer));
+	sync_sequence.push_back(0);
+	transform_channel.add_slot();
+	interest.add_slot();
+	scheduler.add_slot();
+	baselines.add_slot();
+	if (p_synchronizer->net_id != 0) {
+		net_ids.insert(p_synchronizer->net_id, p_synchronizer);
+	}
+}
+
+void SceneSynchronizerServer::unregister_synchronizer(SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_NULL(p_synchronizer);
+	const int32_t index = p_synchronizer->server_index;
+	if (index < 0) {
+		return;
+	}
+	ERR_FAIL_COND(uint32_t(index) >= synchronizers.size() || synchronizers[index] != p_synchronizer);
+
+	// Swap-remove to keep the arrays dense.
+	const uint32_t last = synchronizers.size() - 1;
+	if (uint32_t(index) != last) {
+		synchronizers[index] = synchronizers[last];
+		sync_intervals[index] = sync_intervals[last];
+		delta_intervals[index] = delta_intervals[last];
+		last_sync_usec[index] = last_sync_usec[last];
+		last_delta_usec[index] = last_delta_usec[last];
+		phases[index] = phases[last];
+		sync_sequence[index] = sync_sequence[last];
+		synchronizers[index]->server_index = index;
+	}
+	synchronizers.resize(last);
+	sync_intervals.resize(last);
+	delta_intervals.resize(last);
+	last_sync_usec.resize(last);
+	last_delta_usec.resize(last);
+	phases.resize(last);
+	sync_sequence.resize(last);
+	transform_channel.remove_slot(index);
+	interest.remove_slot(index, p_synchronizer);
+	scheduler.remove_slot(index);
+	baselines.remove_slot(index);
+	net_ids.remove(p_synchronizer->net_id, p_synchronizer);
+
+	p_synchronizer->server_index = -1;
+}
+
+void SceneSynchronizerServer::update_intervals(SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_NULL(p_synchronizer);
+	const int32_t index = p_synchronizer->server_index;
+	if (index < 0) {
+		return;
+	}
+	sync_intervals[index] = p_synchronizer->sync_interval_usec;
+	delta_intervals[index] = p_synchronizer->delta_interval_usec;
+}
+
+void SceneSynchronizerServer::update_net_id(SceneSynchronizer *p_synchronizer, uint32_t p_previous_net_id) {
+	ERR_FAIL_NULL(p_synchronizer);
+	if (p_synchronizer->server_index < 0) {
+		return;
+	}
+	net_ids.remove(p_previous_net_id, p_synchronizer);
+	if (p_synchronizer->net_id != 0) {
+		net_ids.insert(p_synchronizer->net_id, p_synchronizer);
+		const uint32_t index = p_synchronizer->server_index;
+		const uint32_t phase = _assign_phase(p_synchronizer);
+		if (phase != phases[index]) {
+			phases[index] = phase;
+			last_sync_usec[index] = _rebase_last_usec(index, last_sync_usec[index], sync_intervals[index]);
+			last_delta_usec[index] = _rebase_last_usec(index, last_delta_usec[index], delta_intervals[index]);
+		}
+	}
+}
+
+// Net IDs are hashed so peers derive the same phases; synchronizers without one advance a golden ratio sequence. Both
+// keep consecutive slots evenly spread over the interval.
+uint32_t SceneSynchronizerServer::_assign_phase(const SceneSynchronizer *p_synchronizer) {
+	if (p_synchronizer->net_id != 0) {
+		return p_synchronizer->net_id * 2654435769u;
+	}
+	next_phase += 2654435769u;
+	return next_phase;
+}
+
+// With staggering, each slot is due whenever its phase-shifted clock crosses an interval boundary, so the average rate
+// stays one send per interval while different slots fall on different frames.
+uint64_t SceneSynchronizerServer::_get_next_due_usec(uint32_t p_index, uint64_t p_last_usec, uint64_t p_interval) const {
+	if (!phase_staggering || p_interval == 0) {
+		return p_last_usec + p_interval;
+	}
+	const uint64_t phase = (p_interval * phases[p_index]) >> 32;
+	return ((p_last_usec + phase) / p_interval + 1) * p_interval - phase;
+}
+
+// Moves a last send time back to the latest boundary of the slot's current phase, so the next send falls on the new
+// phase within one interval of the previous one. Moving it back only widens the next delta, so no change is lost.
+uint64_t SceneSynchronizerServer::_rebase_last_usec(uint32_t p_index, uint64_t p_last_usec, uint64_t p_interval) const {
+	if (!phase_staggering || p_interval == 0 || p_last_usec == 0) {
+		return p_last_usec;
+	}
+	const uint64_t phase = (p_interval * phases[p_index]) >> 32;
+	const uint64_t boundary = (p_last_usec + phase) / p_interval * p_interval;
+	return boundary > phase ? boundary - phase : 0;
+}
+
+// Shared sync states go out at the full rate and lower tiers take every second or fourth one, offset by phase so the
+// skipped sends of different slots do not line up. Deltas are never skipped as they only carry what changed since the
+// previous one.
+bool SceneSynchronizerServer::_is_rate_tier_due(const InterestManager::Peer *p_peer, uint32_t p_index) const {
+	const uint8_t tier = InterestManager::get_rate_tier(p_peer, synchronizers[p_index]);
+	const uint32_t mask = (1u << tier) - 1;
+	return ((sync_sequence[p_index] + (phases[p_index] >> 30)) & mask) == 0;
+}
+
+void SceneSynchronizerServer::set_phase_staggering(bool p_enabled) {
+	phase_staggering = p_enabled;
+}
+
+bool SceneSynchronizerServer::is_phase_staggering() const {
+	return phase_staggering;
+}
+
+int64_t SceneSynchronizerServer::get_due_count(uint64_t p_cur_usec, bool p_delta) const {
+	const LocalVector<uint64_t> &last_usec = p_delta ? last_delta_usec : last_sync_usec;
+	const LocalVector<uint64_t> &intervals = p_delta ? delta_intervals : sync_intervals;
+	int64_t count = 0;
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (p_cur_usec >= _get_next_due_usec(i, last_usec[i], intervals[i])) {
+			count++;
+		}
+	}
+	return count;
+}
+
+// Number of synchronizers that become due on each of the next `frames` frames, assuming every due state is sent.
+PackedInt32Array SceneSynchronizerServer::get_due_histogram(uint64_t p_cur_usec, uint64_t p_frame_usec, int32_t p_frames, bool p_delta) const {
+	PackedInt32Array histogram;
+	ERR_FAIL_COND_V(p_frame_usec == 0 || p_frames <= 0, histogram);
+	histogram.resize(p_frames);
+	histogram.fill(0);
+	int32_t *counts = histogram.ptrw();
+
+	const LocalVector<uint64_t> &last_usec = p_delta ? last_delta_usec : last_sync_usec;
+	const LocalVector<uint64_t> &intervals = p_delta ? delta_intervals : sync_intervals;
+	const uint64_t end_usec = p_cur_usec + p_frame_usec * (p_frames - 1);
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		uint64_t last = last_usec[i];
+		int64_t frame = 0;
+		while (true) {
+			const uint64_t due = MAX(_get_next_due_usec(i, last, intervals[i]), p_cur_usec + p_frame_usec * frame);
+			if (due > end_usec) {
+				break;
+			}
+			// Sent on the first frame at or after it becomes due.
+			frame = (due - p_cur_usec + p_frame_usec - 1) / p_frame_usec;
+			counts[frame]++;
+			last = p_cur_usec + p_frame_usec * frame;
+			frame++;
+		}
+	}
+	return histogram;
+}
+
+int64_t SceneSynchronizerServer::get_synchronizer_count() const {
+	return synchronizers.size();
+}
+
+TypedArray<SceneSynchronizer> SceneSynchronizerServer::get_synchronizers() const {
+	TypedArray<SceneSynchronizer> result;
+	result.resize(synchronizers.size());
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		result[i] = synchronizers[i];
+	}
+	return result;
+}
+
+int64_t SceneSynchronizerServer::gather_sync_states(uint64_t p_cur_usec, Array r_synchronizers, Array r_offsets, Array r_values) {
+	r_synchronizers.clear();
+	r_offsets.clear();
+	r_values.clear();
+
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (p_cur_usec < _get_next_due_usec(i, last_sync_usec[i], sync_intervals[i])) {
+			// Too soon skip sync synchronization.
+			continue;
+		}
+		if (!interest.is_relevant(i)) {
+			continue;
+		}
+
+		const int64_t offset = r_values.size();
+		if (synchronizers[i]->_append_sync_values(r_values) != OK) {
+			r_values.resize(offset);
+			continue;
+		}
+		last_sync_usec[i] = p_cur_usec;
+
+		if (r_values.size() == offset) {
+			continue;
+		}
+		r_synchronizers.push_back(synchronizers[i]);
+		r_offsets.push_back(offset);
+	}
+
+	return r_synchronizers.size();
+}
+
+int64_t SceneSynchronizerServer::gather_delta_states(uint64_t p_cur_usec, Array r_synchronizers, Array r_offsets, Array r_props, Array r_values) {
+	r_synchronizers.clear();
+	r_offsets.clear();
+	r_props.clear();
+	r_values.clear();
+
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (p_cur_usec < _get_next_due_usec(i, last_delta_usec[i], delta_intervals[i])) {
+			// Too soon skip delta synchronization.
+			continue;
+		}
+		if (!interest.is_relevant(i)) {
+			continue;
+		}
+
+		const int64_t offset = r_values.size();
+		if (synchronizers[i]->_append_delta_state(p_cur_usec, last_delta_usec[i], r_props, r_values) != OK) {
+			r_props.resize(offset);
+			r_values.resize(offset);
+			continue;
+		}
+		last_delta_usec[i] = p_cur_usec;
+
+		if (r_values.size() == offset) {
+			continue;
+		}
+		r_synchronizers.push_back(synchronizers[i]);
+		r_offsets.push_back(offset);
+	}
+
+	return r_synchronizers.size();
+}
+
+// Packed batches are a sequence of entries: varint net_id, varint payload size, payload.
+void SceneSynchronizerServer::_write_entry(StateWriter &r_writer, uint32_t p_net_id) {
+	_write_entry(r_writer, p_net_id, entry_writer.get_data(), entry_writer.get_position());
+}
+
+void SceneSynchronizerServer::_write_entry(StateWriter &r_writer, uint32_t p_net_id, const uint8_t *p_data, int64_t p_size) {
+	r_writer.put_varint(p_net_id);
+	r_writer.put_varint(p_size);
+	r_writer.put_bytes(p_data, p_size);
+}
+
+int64_t SceneSynchronizerServer::_get_entry_size(uint32_t p_net_id, int64_t p_size) {
+	int64_t header = 2;
+	for (uint64_t v = p_net_id; v >= 0x80; v >>= 7) {
+		header++;
+	}
+	for (uint64_t v = p_size; v >= 0x80; v >>= 7) {
+		header++;
+	}
+	return header + p_size;
+}
+
+// Encodes the synchronizer's sync state into entry_writer if it is due. Returns false when there is nothing to send.
+bool SceneSynchronizerServer::_encode_sync_entry(uint32_t p_index, uint64_t p_cur_usec) {
+	if (p_cur_usec < _get_next_due_usec(p_index, last_sync_usec[p_index], sync_intervals[p_index])) {
+		// Too soon skip sync synchronization.
+		return false;
+	}
+	if (!interest.is_relevant(p_index)) {
+		return false;
+	}
+
+	entry_writer.clear();
+	if (synchronizers[p_index]->_write_sync_state(entry_writer) != OK) {
+		return false;
+	}
+	last_sync_usec[p_index] = p_cur_usec;
+	sync_sequence[p_index]++;
+	return entry_writer.get_position() > 0;
+}
+
+bool SceneSynchronizerServer::_encode_delta_entry(uint32_t p_index, uint64_t p_cur_usec) {
+	if (p_cur_usec < _get_next_due_usec(p_index, last_delta_usec[p_index], delta_intervals[p_index])) {
+		// Too soon skip delta synchronization.
+		return false;
+	}
+	if (!interest.is_relevant(p_index)) {
+		return false;
+	}
+
+	SceneSynchronizer *synchronizer = synchronizers[p_index];
+	if (synchronizer->last_watch_usec != p_cur_usec) {
+		if (synchronizer->_watch_changes(p_cur_usec) != OK) {
+			return false;
+		}
+		synchronizer->last_watch_usec = p_cur_usec;
+	}
+
+	entry_writer.clear();
+	synchronizer->_write_delta_state(last_delta_usec[p_index], entry_writer);
+	last_delta_usec[p_index] = p_cur_usec;
+
+	// A lone zero count means nothing changed.
+	return entry_writer.get_position() > 1;
+}
+
+PackedByteArray SceneSynchronizerServer::gather_sync_states_packed(uint64_t p_cur_usec) {
+	StateWriter writer;
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (_encode_sync_entry(i, p_cur_usec)) {
+			_write_entry(writer, synchronizers[i]->net_id);
+		}
+	}
+	return writer.finish();
+}
+
+PackedByteArray SceneSynchronizerServer::gather_delta_states_packed(uint64_t p_cur_usec) {
+	StateWriter writer;
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (_encode_delta_entry(i, p_cur_usec)) {
+			_write_entry(writer, synchronizers[i]->net_id);
+		}
+	}
+	return writer.finish();
+}
+
+SceneSynchronizer *SceneSynchronizerServer::get_synchronizer_by_net_id(uint32_t p_net_id) const {
+	return net_ids.lookup(p_net_id);
+}
+
+// Applies every entry of a packed batch (as produced by gather_*_states_packed, or returned by receive_packet) to the
+// synchronizer registered under its net ID. Entries that fail to apply are skipped. Returns the number of entries
+// applied, or -1 if the batch framing is malformed.
+int64_t SceneSynchronizerServer::apply_batch(const PackedByteArray &p_batch, bool p_delta) {
+	StateReader reader(p_batch);
+	int64_t applied = 0;
+	while (!reader.is_eof()) {
+		const uint64_t net_id = reader.get_varint();
+		const uint64_t size = reader.get_varint();
+		ERR_FAIL_COND_V(reader.has_failed() || net_id > UINT32_MAX || size > uint64_t(reader.get_available()), -1);
+		const int64_t end = reader.get_position() + int64_t(size);
+
+		SceneSynchronizer *synchronizer = net_ids.lookup(uint32_t(net_id));
+		if (!synchronizer) {
+			// Entities that are not spawned locally are skipped.
+			reader.seek(end);
+			continue;
+		}
+		const Error err = p_delta ? synchronizer->_read_delta_state(reader) : synchronizer->_read_sync_state(reader);
+		if (err != OK || reader.has_failed() || reader.get_position() != end) {
+			// Entries are framed, so one that fails (e.g. a root that is not ready yet) does not affect the others.
+			ERR_PRINT(vformat("Failed to apply batch entry for net ID %d.", net_id));
+			reader.seek(end);
+			continue;
+		}
+		applied++;
+	}
+	return applied;
+}
+
+void SceneSynchronizerServer::set_interest_cell_size(real_t p_size) {
+	interest.set_cell_size(p_size);
+}
+
+real_t SceneSynchronizerServer::get_interest_cell_size() const {
+	return interest.get_cell_size();
+}
+
+void SceneSynchronizerServer::set_half_rate_distance(real_t p_distance) {
+	interest.set_half_rate_distance(p_distance);
+}
+
+real_t SceneSynchronizerServer::get_half_rate_distance() const {
+	return interest.get_half_rate_distance();
+}
+
+void SceneSynchronizerServer::set_quarter_rate_distance(real_t p_distance) {
+	interest.set_quarter_rate_distance(p_distance);
+}
+
+real_t SceneSynchronizerServer::get_quarter_rate_distance() const {
+	return interest.get_quarter_rate_distance();
+}
+
+void SceneSynchronizerServer::set_rate_tier_callback(const Callable &p_callback) {
+	interest.set_rate_tier_callback(p_callback);
+}
+
+Callable SceneSynchronizerServer::get_rate_tier_callback() const {
+	return interest.get_rate_tier_callback();
+}
+
+SceneSynchronizerServer::RateTier SceneSynchronizerServer::get_rate_tier(int32_t p_peer_id, SceneSynchronizer *p_synchronizer) const {
+	return RateTier(InterestManager::get_rate_tier(interest.get_peer(p_peer_id), p_synchronizer));
+}
+
+void SceneSynchronizerServer::set_interest_peer(int32_t p_peer_id, const Vector3 &p_origin, real_t p_radius) {
+	interest.set_peer(p_peer_id, p_origin, p_radius);
+}
+
+void SceneSynchronizerServer::set_interest_peer_filter(int32_t p_peer_id, const Callable &p_filter) {
+	interest.set_peer_filter(p_peer_id, p_filter);
+}
+
+void SceneSynchronizerServer::remove_interest_peer(int32_t p_peer_id) {
+	interest.remove_peer(p_peer_id);
+}
+
+void SceneSynchronizerServer::update_interest() {
+	interest.update(synchronizers);
+}
+
+TypedArray<SceneSynchronizer> SceneSynchronizerServer::_to_array(const LocalVector<SceneSynchronizer *> &p_synchronizers) {
+	TypedArray<SceneSynchronizer> result;
+	result.resize(p_synchronizers.size());
+	for (uint32_t i = 0; i < p_synchronizers.size(); i++) {
+		result[i] = p_synchronizers[i];
+	}
+	return result;
+}
+
+TypedArray<SceneSynchronizer> SceneSynchronizerServer::get_relevant_synchronizers(int32_t p_peer_id) const {
+	const InterestManager::Peer *peer = interest.get_peer(p_peer_id);
+	ERR_FAIL_NULL_V_MSG(peer, TypedArray<SceneSynchronizer>(), vformat("Interest peer %d is not registered.", p_peer_id));
+	LocalVector<SceneSynchronizer *> relevant;
+	relevant.reserve(peer->relevant.size());
+	for (SceneSynchronizer *synchronizer : peer->relevant) {
+		relevant.push_back(synchronizer);
+	}
+	return _to_array(relevant);
+}
+
+TypedArray<SceneSynchronizer> SceneSynchronizerServer::get_entered_synchronizers(int32_t p_peer_id) const {
+	const InterestManager::Peer *peer = interest.get_peer(p_peer_id);
+	ERR_FAIL_NULL_V_MSG(peer, TypedArray<SceneSynchronizer>(), vformat("Interest peer %d is not registered.", p_peer_id));
+	return _to_array(peer->entered);
+}
+
+TypedArray<SceneSynchronizer> SceneSynchronizerServer::get_exited_synchronizers(int32_t p_peer_id) const {
+	const InterestManager::Peer *peer = interest.get_peer(p_peer_id);
+	ERR_FAIL_NULL_V_MSG(peer, TypedArray<SceneSynchronizer>(), vformat("Interest peer %d is not registered.", p_peer_id));
+	return _to_array(peer->exited);
+}
+
+// Each state is encoded once, then copied into the batch of every peer it is relevant to.
+Dictionary SceneSynchronizerServer::_gather_states_for_peers(uint64_t p_cur_usec, bool p_delta) {
+	LocalVector<int32_t> peer_ids;
+	LocalVector<const InterestManager::Peer *> peers;
+	for (const KeyValue<int32_t, InterestManager::Peer> &E : interest.get_peers()) {
+		peer_ids.push_back(E.key);
+		peers.push_back(&E.value);
+	}
+	LocalVector<StateWriter> writers;
+	writers.resize(peers.size());
+
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (!(p_delta ? _encode_delta_entry(i, p_cur_usec) : _encode_sync_entry(i, p_cur_usec))) {
+			continue;
+		}
+		SceneSynchronizer *synchronizer = synchronizers[i];
+		for (uint32_t p = 0; p < peers.size(); p++) {
+			if (peers[p]->relevant.has(synchronizer) && (p_delta || _is_rate_tier_due(peers[p], i))) {
+				_write_entry(writers[p], synchronizer->net_id);
+			}
+		}
+	}
+
+	Dictionary result;
+	for (uint32_t p = 0; p < peers.size(); p++) {
+		if (writers[p].get_position() > 0) {
+			result[peer_ids[p]] = writers[p].finish();
+		}
+	}
+	return result;
+}
+
+Dictionary SceneSynchronizerServer::gather_sync_states_for_peers(uint64_t p_cur_usec) {
+	return _gather_states_for_peers(p_cur_usec, false);
+}
+
+Dictionary SceneSynchronizerServer::gather_delta_states_for_peers(uint64_t p_cur_usec) {
+	return _gather_states_for_peers(p_cur_usec, true);
+}
+
+void SceneSynchronizerServer::set_peer_bandwidth_budget(int32_t p_peer_id, int64_t p_bytes) {
+	scheduler.set_peer_budget(p_peer_id, p_bytes);
+}
+
+int64_t SceneSynchronizerServer::get_peer_bandwidth_budget(int32_t p_peer_id) const {
+	const PriorityScheduler::Peer *peer = scheduler.get_peer(p_peer_id);
+	return peer ? peer->budget : 0;
+}
+
+void SceneSynchronizerServer::remove_peer_bandwidth_budget(int32_t p_peer_id) {
+	scheduler.remove_peer(p_peer_id);
+}
+
+void SceneSynchronizerServer::_reset_scratch() {
+	scratch_writer.clear();
+	scratch_offsets.resize(synchronizers.size());
+	scratch_sizes.resize(synchronizers.size());
+	scratch_since_usec.resize(synchronizers.size());
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		scratch_offsets[i] = -1;
+	}
+}
+
+// Encodes a slot's state into the scratch buffer unless an entry with the same baseline is already there.
+bool SceneSynchronizerServer::_encode_scratch_entry(uint32_t p_index, bool p_delta, uint64_t p_since_usec) {
+	if (scratch_offsets[p_index] >= 0 && (!p_delta || scratch_since_usec[p_index] == p_since_usec)) {
+		return scratch_sizes[p_index] > 0;
+	}
+
+	entry_writer.clear();
+	SceneSynchronizer *synchronizer = synchronizers[p_index];
+	const Error err = p_delta ? synchronizer->_write_delta_state(p_since_usec, entry_writer) : synchronizer->_write_sync_state(entry_writer);
+	const int64_t size = err == OK ? entry_writer.get_position() : 0;
+
+	scratch_offsets[p_index] = scratch_writer.get_position();
+	scratch_sizes[p_index] = size;
+	scratch_since_usec[p_index] = p_since_usec;
+	scratch_writer.put_bytes(entry_writer.get_data(), size);
+	return size > 0;
+}
+
+// Every peer with a budget gets its own batch. Due states accumulate priority until they fit, highest first, and each
+// encoding is shared between peers that need the same state.
+Dictionary SceneSynchronizerServer::_gather_states_budgeted(uint64_t p_cur_usec, bool p_delta) {
+	_reset_scratch();
+	const LocalVector<uint64_t> &intervals = p_delta ? delta_intervals : sync_intervals;
+
+	// Deltas are computed from watchers, polled once per interval regardless of how many peers are served.
+	LocalVector<uint64_t> last_change_usec;
+	if (p_delta) {
+		last_change_usec.resize(synchronizers.size());
+		for (uint32_t i = 0; i < synchronizers.size(); i++) {
+			SceneSynchronizer *synchronizer = synchronizers[i];
+			if (p_cur_usec >= _get_next_due_usec(i, last_delta_usec[i], delta_intervals[i]) && synchronizer->last_watch_usec != p_cur_usec) {
+				if (synchronizer->_watch_changes(p_cur_usec) == OK) {
+					synchronizer->last_watch_usec = p_cur_usec;
+				}
+				last_delta_usec[i] = p_cur_usec;
+			}
+			last_change_usec[i] = synchronizer->_get_last_change_usec();
+		}
+	}
+
+	Dictionary result;
+	LocalVector<PriorityScheduler::Candidate> candidates;
+	for (KeyValue<int32_t, PriorityScheduler::Peer> &E : scheduler.get_peers()) {
+		PriorityScheduler::Peer &peer = E.value;
+		LocalVector<float> &priorities = p_delta ? peer.delta_priority : peer.sync_priority;
+		LocalVector<uint64_t> &last_sent_usec = p_delta ? peer.last_delta_usec : peer.last_sync_usec;
+		const InterestManager::Peer *interest_peer = interest.get_peer(E.key);
+
+		candidates.clear();
+		for (uint32_t i = 0; i < synchronizers.size(); i++) {
+			SceneSynchronizer *synchronizer = synchronizers[i];
+			// Lower tiers stretch the interval; deltas still cover everything since this peer's last send.
+			const uint8_t tier = InterestManager::get_rate_tier(interest_peer, synchronizer);
+			if (p_cur_usec < _get_next_due_usec(i, last_sent_usec[i], intervals[i] << tier)) {
+				continue;
+			}
+			if (p_delta && last_change_usec[i] <= last_sent_usec[i]) {
+				continue;
+			}
+			if (!interest.is_relevant_to(E.key, synchronizer)) {
+				continue;
+			}
+			priorities[i] += synchronizer->replication_priority;
+			PriorityScheduler::Candidate candidate;
+			candidate.priority = priorities[i];
+			candidate.index = i;
+			candidates.push_back(candidate);
+		}
+		candidates.sort();
+
+		StateWriter writer;
+		int64_t used = 0;
+		for (const PriorityScheduler::Candidate &candidate : candidates) {
+			const uint32_t i = candidate.index;
+			if (!_encode_scratch_entry(i, p_delta, last_sent_usec[i])) {
+				continue;
+			}
+			const uint32_t net_id = synchronizers[i]->net_id;
+			const int64_t size = _get_entry_size(net_id, scratch_sizes[i]);
+			if (used + size > peer.budget && used > 0) {
+				// Deferred, keeps its accumulated priority.
+				continue;
+			}
+			_write_entry(writer, net_id, scratch_writer.get_data() + scratch_offsets[i], scratch_sizes[i]);
+			used += size;
+			priorities[i] = 0;
+			last_sent_usec[i] = p_cur_usec;
+		}
+
+		if (used > 0) {
+			result[E.key] = writer.finish();
+		}
+	}
+
+	if (!p_delta) {
+		for (uint32_t i = 0; i < synchronizers.size(); i++) {
+			if (scratch_offsets[i] >= 0) {
+				last_sync_usec[i] = p_cur_usec;
+			}
+		}
+	}
+	return result;
+}
+
+Dictionary SceneSynchronizerServer::gather_sync_states_budgeted(uint64_t p_cur_usec) {
+	return _gather_states_budgeted(p_cur_usec, false);
+}
+
+Dictionary SceneSynchronizerServer::gather_delta_states_budgeted(uint64_t p_cur_usec) {
+	return _gather_states_budgeted(p_cur_usec, true);
+}
+
+void SceneSynchronizerServer::add_baseline_peer(int32_t p_peer_id) {
+	baselines.add_peer(p_peer_id);
+}
+
+void SceneSynchronizerServer::remove_baseline_peer(int32_t p_peer_id) {
+	baselines.remove_peer(p_peer_id);
+}
+
+void SceneSynchronizerServer::acknowledge_snapshot(int32_t p_peer_id, uint32_t p_snapshot_id) {
+	baselines.acknowledge(p_peer_id, p_snapshot_id);
+}
+
+// Makes the next baseline snapshot for the peer carry the full state of a synchronizer, e.g. one the peer reported in
+// apply_baseline_states' failed net IDs.
+void SceneSynchronizerServer::reset_peer_baseline(int32_t p_peer_id, uint32_t p_net_id) {
+	const SceneSynchronizer *synchronizer = net_ids.lookup(p_net_id);
+	ERR_FAIL_NULL_MSG(synchronizer, vformat("No synchronizer with net ID %d.", p_net_id));
+	baselines.reset_slot(p_peer_id, synchronizer->server_index);
+}
+
+// Baseline packets are a varint snapshot id followed by packed entries, each a delta against the newest snapshot of
+// that synchronizer the peer has acknowledged. Receivers acknowledge the snapshot id once the packet is applied.
+Dictionary SceneSynchronizerServer::gather_baseline_states(uint64_t p_cur_usec) {
+	Dictionary result;
+	if (baselines.get_peers().is_empty()) {
+		return result;
+	}
+	const uint32_t snapshot_id = baselines.next_snapshot_id();
+
+	LocalVector<uint8_t> encoded;
+	encoded.resize(synchronizers.size());
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		encoded[i] = 0;
+		if (p_cur_usec < _get_next_due_usec(i, last_sync_usec[i], sync_intervals[i])) {
+			// Too soon skip sync synchronization.
+			continue;
+		}
+		if (!interest.is_relevant(i) || synchronizers[i]->_write_baseline(snapshot_id) != OK) {
+			continue;
+		}
+		last_sync_usec[i] = p_cur_usec;
+		sync_sequence[i]++;
+		encoded[i] = 1;
+	}
+
+	for (KeyValue<int32_t, BaselineTracker::Peer> &E : baselines.get_peers()) {
+		BaselineTracker::Peer &peer = E.value;
+		const InterestManager::Peer *interest_peer = interest.get_peer(E.key);
+		BaselineTracker::Pending pending;
+		pending.id = snapshot_id;
+
+		StateWriter writer;
+		writer.put_varint(snapshot_id);
+		for (uint32_t i = 0; i < synchronizers.size(); i++) {
+			SceneSynchronizer *synchronizer = synchronizers[i];
+			if (!encoded[i] || !interest.is_relevant_to(E.key, synchronizer) || !_is_rate_tier_due(interest_peer, i)) {
+				continue;
+			}
+			entry_writer.clear();
+			if (!synchronizer->_write_baseline_delta(snapshot_id, peer.acked[i], entry_writer)) {
+				continue;
+			}
+			_write_entry(writer, synchronizer->net_id);
+			pending.slots.push_back(i);
+		}
+
+		if (!pending.slots.is_empty()) {
+			baselines.add_pending(peer, std::move(pending));
+			result[E.key] = writer.finish();
+		}
+	}
+	return result;
+}
+
+// Applies a packet from gather_baseline_states(). Returns its snapshot id, to be acknowledged to the sender, or -1 if
+// the packet is malformed. Net IDs whose entry could not be applied are appended to r_failed_net_ids.
+int64_t SceneSynchronizerServer::apply_baseline_states(const PackedByteArray &p_packet, Array r_failed_net_ids) {
+	StateReader reader(p_packet);
+	const uint64_t snapshot_id = reader.get_varint();
+	ERR_FAIL_COND_V(reader.has_failed() || snapshot_id == 0 || snapshot_id > UINT32_MAX, -1);
+
+	while (!reader.is_eof()) {
+		const uint64_t net_id = reader.get_varint();
+		const uint64_t size = reader.get_varint();
+		ERR_FAIL_COND_V(reader.has_failed() || net_id > UINT32_MAX || size > uint64_t(reader.get_available()), -1);
+		const int64_t end = reader.get_position() + int64_t(size);
+
+		SceneSynchronizer *synchronizer = net_ids.lookup(uint32_t(net_id));
+		if (!synchronizer) {
+			// Entities that are not spawned locally are skipped.
+			reader.seek(end);
+			continue;
+		}
+		const Error err = synchronizer->_read_baseline_delta(snapshot_id, reader);
+		if (err != OK || reader.has_failed() || reader.get_position() != end) {
+			// E.g. the referenced baseline is missing after a local respawn. The rest of the packet still applies, and
+			// the sender can reset_peer_baseline() the reported net IDs to resend their full state.
+			ERR_PRINT(vformat("Failed to apply baseline entry for net ID %d.", net_id));
+			r_failed_net_ids.push_back(net_id);
+			reader.seek(end);
+		}
+	}
+	return snapshot_id;
+}
+
+void SceneSynchronizerServer::set_packet_mtu(int64_t p_mtu) {
+	aggregator.set_mtu(p_mtu);
+}
+
+int64_t SceneSynchronizerServer::get_packet_mtu() const {
+	return aggregator.get_mtu();
+}
+
+// Like _gather_states_for_peers, but every peer's entries are split into MTU-sized packets. Without interest peers all
+// states go to a single set of packets keyed by peer 0 for broadcasting.
+Dictionary SceneSynchronizerServer::_gather_packets(uint64_t p_cur_usec, bool p_delta) {
+	LocalVector<int32_t> peer_ids;
+	LocalVector<const InterestManager::Peer *> peers;
+	for (const KeyValue<int32_t, InterestManager::Peer> &E : interest.get_peers()) {
+		peer_ids.push_back(E.key);
+		peers.push_back(&E.value);
+	}
+	if (peers.is_empty()) {
+		peer_ids.push_back(0);
+		peers.push_back(nullptr);
+	}
+	LocalVector<PacketAggregator::Batch> batches;
+	batches.resize(peers.size());
+
+	for (uint32_t i = 0; i < synchronizers.size(); i++) {
+		if (!(p_delta ? _encode_delta_entry(i, p_cur_usec) : _encode_sync_entry(i, p_cur_usec))) {
+			continue;
+		}
+		SceneSynchronizer *synchronizer = synchronizers[i];
+		for (uint32_t p = 0; p < peers.size(); p++) {
+			if (!peers[p] || (peers[p]->relevant.has(synchronizer) && (p_delta || _is_rate_tier_due(peers[p], i)))) {
+				aggregator.add_entry(batches[p], synchronizer->net_id, entry_writer.get_data(), entry_writer.get_position());
+			}
+		}
+	}
+
+	Dictionary result;
+	for (uint32_t p = 0; p < peers.size(); p++) {
+		TypedArray<PackedByteArray> packets = aggregator.finish(batches[p]);
+		if (!packets.is_empty()) {
+			result[peer_ids[p]] = packets;
+		}
+	}
+	return result;
+}
+
+Dictionary SceneSynchronizerServer::gather_sync_packets(uint64_t p_cur_usec) {
+	return _gather_packets(p_cur_usec, false);
+}
+
+Dictionary SceneSynchronizerServer::gather_delta_packets(uint64_t p_cur_usec) {
+	return _gather_packets(p_cur_usec, true);
+}
+
+// Returns the packed batch carried by the packet, or an empty array while a fragmented entry is still incomplete.
+PackedByteArray SceneSynchronizerServer::receive_packet(int32_t p_peer_id, const PackedByteArray &p_packet) {
+	return aggregator.receive(p_peer_id, p_packet);
+}
+
+void SceneSynchronizerServer::remove_packet_peer(int32_t p_peer_id) {
+	aggregator.remove_peer(p_peer_id);
+}
+
+void SceneSynchronizerServer::set_transform_position_step(float p_step) {
+	transform_channel.set_position_step(p_step);
+}
+
+float SceneSynchronizerServer::get_transform_position_step() const {
+	return transform_channel.get_position_step();
+}
+
+void SceneSynchronizerServer::set_transform_refresh_interval(int64_t p_interval) {
+	ERR_FAIL_COND_MSG(p_interval < 0 || p_interval > UINT32_MAX, "Transform refresh interval must be a non-negative 32-bit value.");
+	transform_channel.set_refresh_interval(uint32_t(p_interval));
+}
+
+int64_t SceneSynchronizerServer::get_transform_refresh_interval() const {
+	return transform_channel.get_refresh_interval();
+}
+
+void SceneSynchronizerServer::reset_transform_baseline() {
+	transform_channel.reset_baseline();
+}
+
+PackedByteArray SceneSynchronizerServer::gather_transforms_packed() {
+	StateWriter writer;
+	transform_channel.write(synchronizers, writer);
+	return writer.finish();
+}
+
+Error SceneSynchronizerServer::apply_transforms_packed(const PackedByteArray &p_packet) {
+	if (p_packet.is_empty()) {
+		return OK;
+	}
+
+	StateReader reader(p_packet);
+	const float position_step = reader.get_float();
+	ERR_FAIL_COND_V(reader.has_failed() || !(position_step > 0.0f), ERR_INVALID_DATA);
+
+	while (!reader.is_eof()) {
+		const uint64_t net_id = reader.get_varint();
+		ERR_FAIL_COND_V(reader.has_failed() || net_id > UINT32_MAX, ERR_INVALID_DATA);
+		SceneSynchronizer *synchronizer = net_ids.lookup(uint32_t(net_id));
+		// Entities that are not spawned locally are skipped.
+		Error err = synchronizer ? TransformChannel::read_entry(reader, position_step, synchronizer) : TransformChannel::skip_entry(reader);
+		ERR_FAIL_COND_V(err == ERR_INVALID_DATA, err);
+	}
+	return OK;
+}
+
+// Records the current sync state of every synchronizer with history enabled. Returns the number recorded.
+int64_t SceneSynchronizerServer::record_history(uint64_t p_cur_usec) {
+	int64_t count = 0;
+	for (SceneSynchronizer *synchronizer : synchronizers) {
+		if (synchronizer->history_enabled && synchronizer->record_history(p_cur_usec)) {
+			count++;
+		}
+	}
+	return count;
+}
+
+// Sync values of the synchronizer registered under `p_net_id` as they were at `p_usec`, interpolated between recorded
+// frames. Empty if there is no such synchronizer or it has no history.
+Array SceneSynchronizerServer::get_state_at(uint32_t p_net_id, uint64_t p_usec) const {
+	const SceneSynchronizer *synchronizer = net_ids.lookup(p_net_id);
+	return synchronizer ? synchronizer->get_history_state(p_usec) : Array();
+}
+
+// Net ID to sync values at `p_usec` of every synchronizer whose root node was within `p_radius` of `p_origin` at that
+// time. 2D roots are placed on the z = 0 plane.
+Dictionary SceneSynchronizerServer::rewind_within_radius(const Vector3 &p_origin, real_t p_radius, uint64_t p_usec) {
+	Dictionary states;
+	const real_t radius_squared = p_radius * p_radius;
+	Vector3 position;
+	for (SceneSynchronizer *synchronizer : synchronizers) {
+		if (synchronizer->net_id == 0 || synchronizer->history.get_count() == 0 || !synchronizer->_get_root_position(position)) {
+			continue;
+		}
+		if (!synchronizer->history.sample_position(p_usec, position) || position.distance_squared_to(p_origin) > radius_squared) {
+			continue;
+		}
+		Array values;
+		synchronizer->history.sample(p_usec, values);
+		states[synchronizer->net_id] = values;
+	}
+	return states;
+}
+
+SceneSynchronizerServer::SceneSynchronizerServer() {
+	singleton = this;
+}
+
+SceneSynchronizerServer::~SceneSynchronizerServer() {
+	for (SceneSynchronizer *synchronizer : synchronizers) {
+		synchronizer->server_index = -1;
+	}
+	singleton = nullptr;
+}
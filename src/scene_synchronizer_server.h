@@ -0,0 +1,168 @@
+#pragma once
+
+#include "baseline_tracker.h"
+#include "interest_manager.h"
+#include "net_id_registry.h"
+#include "packet_aggregator.h"
+#include "priority_scheduler.h"
+#include "state_codec.h"
+#include "transform_channel.h"
+
+#include <godot_cpp/core/class_db.hpp>
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/classes/wrapped.hpp>
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+namespace godot {
+
+class SceneSynchronizer;
+
+// Tracks every active SceneSynchronizer so the outbound states of all of them can be gathered in a single call per
+// tick. Scheduling state is kept in parallel arrays indexed by SceneSynchronizer::server_index.
+class SceneSynchronizerServer : public Object {
+	GDCLASS(SceneSynchronizerServer, Object);
+
+public:
+	enum RateTier {
+		RATE_TIER_FULL = InterestManager::RATE_TIER_FULL,
+		RATE_TIER_HALF = InterestManager::RATE_TIER_HALF,
+		RATE_TIER_QUARTER = InterestManager::RATE_TIER_QUARTER,
+	};
+
+private:
+	static SceneSynchronizerServer *singleton;
+
+	LocalVector<SceneSynchronizer *> synchronizers;
+	LocalVector<uint64_t> sync_intervals;
+	LocalVector<uint64_t> delta_intervals;
+	LocalVector<uint64_t> last_sync_usec;
+	LocalVector<uint64_t> last_delta_usec;
+	// Fraction of the interval (out of 2^32) each slot's send window is shifted by, so synchronizers sharing an interval
+	// do not all become due on the same frame.
+	LocalVector<uint32_t> phases;
+	// Sync states encoded per slot, used to thin out the shared sync stream for peers on a lower rate tier.
+	LocalVector<uint32_t> sync_sequence;
+	uint32_t next_phase = 0;
+	bool phase_staggering = true;
+	NetIdRegistry net_ids;
+	StateWriter entry_writer;
+	TransformChannel transform_channel;
+	InterestManager interest;
+	PriorityScheduler scheduler;
+	BaselineTracker baselines;
+	PacketAggregator aggregator;
+	// Entries encoded during a budgeted gather, shared by every peer that schedules them.
+	StateWriter scratch_writer;
+	LocalVector<int64_t> scratch_offsets;
+	LocalVector<int64_t> scratch_sizes;
+	LocalVector<uint64_t> scratch_since_usec;
+
+	uint32_t _assign_phase(const SceneSynchronizer *p_synchronizer);
+	uint64_t _get_next_due_usec(uint32_t p_index, uint64_t p_last_usec, uint64_t p_interval) const;
+	uint64_t _rebase_last_usec(uint32_t p_index, uint64_t p_last_usec, uint64_t p_interval) const;
+	bool _is_rate_tier_due(const InterestManager::Peer *p_peer, uint32_t p_index) const;
+	void _write_entry(StateWriter &r_writer, uint32_t p_net_id);
+	void _write_entry(StateWriter &r_writer, uint32_t p_net_id, const uint8_t *p_data, int64_t p_size);
+	static int64_t _get_entry_size(uint32_t p_net_id, int64_t p_size);
+	void _reset_scratch();
+	bool _encode_scratch_entry(uint32_t p_index, bool p_delta, uint64_t p_since_usec);
+	Dictionary _gather_states_budgeted(uint64_t p_cur_usec, bool p_delta);
+	bool _encode_sync_entry(uint32_t p_index, uint64_t p_cur_usec);
+	bool _encode_delta_entry(uint32_t p_index, uint64_t p_cur_usec);
+	Dictionary _gather_states_for_peers(uint64_t p_cur_usec, bool p_delta);
+	Dictionary _gather_packets(uint64_t p_cur_usec, bool p_delta);
+	static TypedArray<SceneSynchronizer> _to_array(const LocalVector<SceneSynchronizer *> &p_synchronizers);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static SceneSynchronizerServer *get_singleton();
+
+	void register_synchronizer(SceneSynchronizer *p_synchronizer);
+	void unregister_synchronizer(SceneSynchronizer *p_synchronizer);
+	void update_intervals(SceneSynchronizer *p_synchronizer);
+	void update_net_id(SceneSynchronizer *p_synchronizer, uint32_t p_previous_net_id);
+
+	void set_phase_staggering(bool p_enabled);
+	bool is_phase_staggering() const;
+	int64_t get_due_count(uint64_t p_cur_usec, bool p_delta = false) const;
+	PackedInt32Array get_due_histogram(uint64_t p_cur_usec, uint64_t p_frame_usec, int32_t p_frames, bool p_delta = false) const;
+
+	int64_t get_synchronizer_count() const;
+	TypedArray<SceneSynchronizer> get_synchronizers() const;
+	const LocalVector<SceneSynchronizer *> &get_synchronizer_list() const { return synchronizers; }
+	SceneSynchronizer *get_synchronizer_by_net_id(uint32_t p_net_id) const;
+
+	int64_t gather_sync_states(uint64_t p_cur_usec, Array r_synchronizers, Array r_offsets, Array r_values);
+	int64_t gather_delta_states(uint64_t p_cur_usec, Array r_synchronizers, Array r_offsets, Array r_props, Array r_values);
+
+	PackedByteArray gather_sync_states_packed(uint64_t p_cur_usec);
+	PackedByteArray gather_delta_states_packed(uint64_t p_cur_usec);
+	int64_t apply_batch(const PackedByteArray &p_batch, bool p_delta = false);
+
+	void set_interest_cell_size(real_t p_size);
+	real_t get_interest_cell_size() const;
+	void set_half_rate_distance(real_t p_distance);
+	real_t get_half_rate_distance() const;
+	void set_quarter_rate_distance(real_t p_distance);
+	real_t get_quarter_rate_distance() const;
+	void set_rate_tier_callback(const Callable &p_callback);
+	Callable get_rate_tier_callback() const;
+	RateTier get_rate_tier(int32_t p_peer_id, SceneSynchronizer *p_synchronizer) const;
+	void set_interest_peer(int32_t p_peer_id, const Vector3 &p_origin, real_t p_radius);
+	void set_interest_peer_filter(int32_t p_peer_id, const Callable &p_filter);
+	void remove_interest_peer(int32_t p_peer_id);
+	void update_interest();
+	TypedArray<SceneSynchronizer> get_relevant_synchronizers(int32_t p_peer_id) const;
+	TypedArray<SceneSynchronizer> get_entered_synchronizers(int32_t p_peer_id) const;
+	TypedArray<SceneSynchronizer> get_exited_synchronizers(int32_t p_peer_id) const;
+	Dictionary gather_sync_states_for_peers(uint64_t p_cur_usec);
+	Dictionary gather_delta_states_for_peers(uint64_t p_cur_usec);
+
+	void set_peer_bandwidth_budget(int32_t p_peer_id, int64_t p_bytes);
+	int64_t get_peer_bandwidth_budget(int32_t p_peer_id) const;
+	void remove_peer_bandwidth_budget(int32_t p_peer_id);
+	Dictionary gather_sync_states_budgeted(uint64_t p_cur_usec);
+	Dictionary gather_delta_states_budgeted(uint64_t p_cur_usec);
+
+	void add_baseline_peer(int32_t p_peer_id);
+	void remove_baseline_peer(int32_t p_peer_id);
+	void acknowledge_snapshot(int32_t p_peer_id, uint32_t p_snapshot_id);
+	void reset_peer_baseline(int32_t p_peer_id, uint32_t p_net_id);
+	Dictionary gather_baseline_states(uint64_t p_cur_usec);
+	int64_t apply_baseline_states(const PackedByteArray &p_packet, Array r_failed_net_ids = Array());
+
+	void set_packet_mtu(int64_t p_mtu);
+	int64_t get_packet_mtu() const;
+	Dictionary gather_sync_packets(uint64_t p_cur_usec);
+	Dictionary gather_delta_packets(uint64_t p_cur_usec);
+	PackedByteArray receive_packet(int32_t p_peer_id, const PackedByteArray &p_packet);
+	void remove_packet_peer(int32_t p_peer_id);
+
+	void set_transform_position_step(float p_step);
+	float get_transform_position_step() const;
+	void set_transform_refresh_interval(int64_t p_interval);
+	int64_t get_transform_refresh_interval() const;
+	void reset_transform_baseline();
+	PackedByteArray gather_transforms_packed();
+	Error apply_transforms_packed(const PackedByteArray &p_packet);
+
+	int64_t record_history(uint64_t p_cur_usec);
+	Array get_state_at(uint32_t p_net_id, uint64_t p_usec) const;
+	Dictionary rewind_within_radius(const Vector3 &p_origin, real_t p_radius, uint64_t p_usec);
+
+	SceneSynchronizerServer();
+	~SceneSynchronizerServer();
+};
+
+} //namespace godot
+
+VARIANT_ENUM_CAST(SceneSynchronizerServer::RateTier);
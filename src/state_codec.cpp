@@ -0,0 +1,921 @@
+#include "state_codec.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+static constexpr double SMALLEST_THREE_RANGE = 0.70710678118654752440; // 1 / sqrt(2)
+
+static uint32_t _bit_mask(uint8_t p_bits) {
+	return p_bits >= 32 ? UINT32_MAX : (1u << p_bits) - 1;
+}
+
+static uint32_t _quantize(double p_value, double p_min, double p_max, uint8_t p_bits) {
+	if (p_max <= p_min) {
+		return 0;
+	}
+	const double t = CLAMP((p_value - p_min) / (p_max - p_min), 0.0, 1.0);
+	return uint32_t(t * _bit_mask(p_bits) + 0.5);
+}
+
+static double _dequantize(uint32_t p_value, double p_min, double p_max, uint8_t p_bits) {
+	return p_min + (p_max - p_min) * (double(p_value) / _bit_mask(p_bits));
+}
+
+static uint16_t _float_to_half(float p_value) {
+	uint32_t x;
+	memcpy(&x, &p_value, sizeof(x));
+	const uint32_t sign = (x >> 16) & 0x8000;
+	const uint32_t mantissa = x & 0x007FFFFF;
+	const int32_t exponent = int32_t((x >> 23) & 0xFF) - 127 + 15;
+
+	if (((x >> 23) & 0xFF) == 0xFF) {
+		// Inf or NaN.
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+	}
+	if (exponent >= 31) {
+		return sign | 0x7C00;
+	}
+	if (exponent <= 0) {
+		if (exponent < -10) {
+			return sign;
+		}
+		// Subnormal half.
+		const uint32_t full = mantissa | 0x00800000;
+		const uint32_t shift = 14 - exponent;
+		uint32_t half = full >> shift;
+		if ((full >> (shift - 1)) & 1) {
+			half++;
+		}
+		return sign | half;
+	}
+
+	uint32_t half = sign | (uint32_t(exponent) << 10) | (mantissa >> 13);
+	if (mantissa & 0x1000) {
+		// Round to nearest, a carry into the exponent is still correct.
+		half++;
+	}
+	return half;
+}
+
+static float _half_to_float(uint16_t p_half) {
+	const uint32_t sign = uint32_t(p_half & 0x8000) << 16;
+	uint32_t exponent = (p_half >> 10) & 0x1F;
+	uint32_t mantissa = p_half & 0x3FF;
+	uint32_t x;
+
+	if (exponent == 0) {
+		if (mantissa == 0) {
+			x = sign;
+		} else {
+			// Normalize the subnormal half.
+			exponent = 127 - 15 + 1;
+			while (!(mantissa & 0x400)) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			x = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+		}
+	} else if (exponent == 31) {
+		x = sign | 0x7F800000 | (mantissa << 13);
+	} else {
+		x = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float value;
+	memcpy(&value, &x, sizeof(value));
+	return value;
+}
+
+uint8_t *StateWriter::_reserve(int64_t p_bytes) {
+	if (position + p_bytes > buffer.size()) {
+		buffer.resize(MAX(buffer.size() * 2, position + p_bytes + 64));
+	}
+	uint8_t *ptr = buffer.ptrw() + position;
+	position += p_bytes;
+	return ptr;
+}
+
+void StateWriter::put_u8(uint8_t p_value) {
+	*_reserve(1) = p_value;
+}
+
+void StateWriter::put_u16(uint16_t p_value) {
+	uint8_t *ptr = _reserve(2);
+	ptr[0] = p_value & 0xFF;
+	ptr[1] = p_value >> 8;
+}
+
+void StateWriter::put_u32(uint32_t p_value) {
+	uint8_t *ptr = _reserve(4);
+	for (int i = 0; i < 4; i++) {
+		ptr[i] = (p_value >> (i * 8)) & 0xFF;
+	}
+}
+
+void StateWriter::patch_u32(int64_t p_position, uint32_t p_value) {
+	ERR_FAIL_COND(p_position < 0 || p_position + 4 > position);
+	uint8_t *ptr = buffer.ptrw() + p_position;
+	for (int i = 0; i < 4; i++) {
+		ptr[i] = (p_value >> (i * 8)) & 0xFF;
+	}
+}
+
+void StateWriter::put_u64(uint64_t p_value) {
+	uint8_t *ptr = _reserve(8);
+	for (int i = 0; i < 8; i++) {
+		ptr[i] = (p_value >> (i * 8)) & 0xFF;
+	}
+}
+
+void StateWriter::put_float(float p_value) {
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	put_u32(bits);
+}
+
+void StateWriter::put_double(double p_value) {
+	uint64_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	put_u64(bits);
+}
+
+void StateWriter::put_real(real_t p_value) {
+	if constexpr (sizeof(real_t) == sizeof(double)) {
+		put_double(p_value);
+	} else {
+		put_float(p_value);
+	}
+}
+
+void StateWriter::put_varint(uint64_t p_value) {
+	while (p_value >= 0x80) {
+		put_u8(uint8_t(p_value) | 0x80);
+		p_value >>= 7;
+	}
+	put_u8(uint8_t(p_value));
+}
+
+void StateWriter::put_zigzag(int64_t p_value) {
+	put_varint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63));
+}
+
+void StateWriter::put_bytes(const uint8_t *p_data, int64_t p_size) {
+	if (p_size <= 0) {
+		return;
+	}
+	memcpy(_reserve(p_size), p_data, p_size);
+}
+
+void StateWriter::put_string(const String &p_value) {
+	CharString utf8 = p_value.utf8();
+	put_varint(utf8.length());
+	put_bytes((const uint8_t *)utf8.get_data(), utf8.length());
+}
+
+void StateWriter::put_value(const Variant &p_value, Variant::Type p_type) {
+	if (p_type == Variant::NIL) {
+		p_type = p_value.get_type();
+		put_u8(uint8_t(p_type));
+	} else if (unlikely(p_value.get_type() != p_type)) {
+		ERR_PRINT(vformat("Expected a value of type %s but got %s.", Variant::get_type_name(p_type), Variant::get_type_name(p_value.get_type())));
+		put_value(UtilityFunctions::type_convert(p_value, p_type), p_type);
+		return;
+	}
+
+	switch (p_type) {
+		case Variant::NIL:
+			break;
+		case Variant::BOOL:
+			put_u8(bool(p_value) ? 1 : 0);
+			break;
+		case Variant::INT:
+			put_zigzag(int64_t(p_value));
+			break;
+		case Variant::FLOAT:
+			put_double(double(p_value));
+			break;
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::NODE_PATH:
+			put_string(String(p_value));
+			break;
+		case Variant::VECTOR2: {
+			const Vector2 v = p_value;
+			put_real(v.x);
+			put_real(v.y);
+		} break;
+		case Variant::VECTOR2I: {
+			const Vector2i v = p_value;
+			put_zigzag(v.x);
+			put_zigzag(v.y);
+		} break;
+		case Variant::RECT2: {
+			const Rect2 r = p_value;
+			put_real(r.position.x);
+			put_real(r.position.y);
+			put_real(r.size.x);
+			put_real(r.size.y);
+		} break;
+		case Variant::RECT2I: {
+			const Rect2i r = p_value;
+			put_zigzag(r.position.x);
+			put_zigzag(r.position.y);
+			put_zigzag(r.size.x);
+			put_zigzag(r.size.y);
+		} break;
+		case Variant::VECTOR3: {
+			const Vector3 v = p_value;
+			put_real(v.x);
+			put_real(v.y);
+			put_real(v.z);
+		} break;
+		case Variant::VECTOR3I: {
+			const Vector3i v = p_value;
+			put_zigzag(v.x);
+			put_zigzag(v.y);
+			put_zigzag(v.z);
+		} break;
+		case Variant::TRANSFORM2D: {
+			const Transform2D t = p_value;
+			for (int i = 0; i < 3; i++) {
+				put_real(t.columns[i].x);
+				put_real(t.columns[i].y);
+			}
+		} break;
+		case Variant::VECTOR4: {
+			const Vector4 v = p_value;
+			put_real(v.x);
+			put_real(v.y);
+			put_real(v.z);
+			put_real(v.w);
+		} break;
+		case Variant::VECTOR4I: {
+			const Vector4i v = p_value;
+			put_zigzag(v.x);
+			put_zigzag(v.y);
+			put_zigzag(v.z);
+			put_zigzag(v.w);
+		} break;
+		case Variant::PLANE: {
+			const Plane p = p_value;
+			put_real(p.normal.x);
+			put_real(p.normal.y);
+			put_real(p.normal.z);
+			put_real(p.d);
+		} break;
+		case Variant::QUATERNION: {
+			const Quaternion q = p_value;
+			put_real(q.x);
+			put_real(q.y);
+			put_real(q.z);
+			put_real(q.w);
+		} break;
+		case Variant::AABB: {
+			const AABB a = p_value;
+			put_real(a.position.x);
+			put_real(a.position.y);
+			put_real(a.position.z);
+			put_real(a.size.x);
+			put_real(a.size.y);
+			put_real(a.size.z);
+		} break;
+		case Variant::BASIS: {
+			const Basis b = p_value;
+			for (int i = 0; i < 3; i++) {
+				put_real(b.rows[i].x);
+				put_real(b.rows[i].y);
+				put_real(b.rows[i].z);
+			}
+		} break;
+		case Variant::TRANSFORM3D: {
+			const Transform3D t = p_value;
+			for (int i = 0; i < 3; i++) {
+				put_real(t.basis.rows[i].x);
+				put_real(t.basis.rows[i].y);
+				put_real(t.basis.rows[i].z);
+			}
+			put_real(t.origin.x);
+			put_real(t.origin.y);
+			put_real(t.origin.z);
+		} break;
+		case Variant::COLOR: {
+			const Color c = p_value;
+			put_float(c.r);
+			put_float(c.g);
+			put_float(c.b);
+			put_float(c.a);
+		} break;
+		default: {
+			const PackedByteArray bytes = UtilityFunctions::var_to_bytes(p_value);
+			put_varint(bytes.size());
+			put_bytes(bytes.ptr(), bytes.size());
+		} break;
+	}
+}
+
+void StateWriter::put_bits(uint32_t p_value, uint8_t p_bits) {
+	uint8_t written = 0;
+	while (written < p_bits) {
+		if (bit_count == 8) {
+			bit_byte = position;
+			put_u8(0);
+			bit_count = 0;
+		}
+		const uint8_t take = MIN(uint8_t(8 - bit_count), uint8_t(p_bits - written));
+		buffer.ptrw()[bit_byte] |= uint8_t(((p_value >> written) & _bit_mask(take)) << bit_count);
+		bit_count += take;
+		written += take;
+	}
+}
+
+void StateWriter::_put_fixed(double p_value, const EncodingProfile &p_profile) {
+	const uint8_t bits = p_profile.get_bits(16);
+	put_bits(_quantize(p_value, p_profile.min, p_profile.max, bits), bits);
+}
+
+void StateWriter::_put_half(float p_value) {
+	put_u16(_float_to_half(p_value));
+}
+
+void StateWriter::put_encoded(const Variant &p_value, Variant::Type p_type, const EncodingProfile &p_profile) {
+	if (p_profile.mode == EncodingProfile::DEFAULT) {
+		put_value(p_value, p_type);
+		return;
+	}
+	if (p_type == Variant::NIL) {
+		p_type = p_value.get_type();
+		put_u8(uint8_t(p_type));
+	} else if (unlikely(p_value.get_type() != p_type)) {
+		ERR_PRINT(vformat("Expected a value of type %s but got %s.", Variant::get_type_name(p_type), Variant::get_type_name(p_value.get_type())));
+		put_encoded(UtilityFunctions::type_convert(p_value, p_type), p_type, p_profile);
+		return;
+	}
+
+	switch (p_profile.mode) {
+		case EncodingProfile::FIXED_POINT: {
+			switch (p_type) {
+				case Variant::FLOAT:
+					_put_fixed(double(p_value), p_profile);
+					return;
+				case Variant::VECTOR2: {
+					const Vector2 v = p_value;
+					_put_fixed(v.x, p_profile);
+					_put_fixed(v.y, p_profile);
+				}
+					return;
+				case Variant::VECTOR3: {
+					const Vector3 v = p_value;
+					_put_fixed(v.x, p_profile);
+					_put_fixed(v.y, p_profile);
+					_put_fixed(v.z, p_profile);
+				}
+					return;
+				case Variant::VECTOR4: {
+					const Vector4 v = p_value;
+					_put_fixed(v.x, p_profile);
+					_put_fixed(v.y, p_profile);
+					_put_fixed(v.z, p_profile);
+					_put_fixed(v.w, p_profile);
+				}
+					return;
+				case Variant::COLOR: {
+					const Color c = p_value;
+					_put_fixed(c.r, p_profile);
+					_put_fixed(c.g, p_profile);
+					_put_fixed(c.b, p_profile);
+					_put_fixed(c.a, p_profile);
+				}
+					return;
+				default:
+					break;
+			}
+		} break;
+		case EncodingProfile::HALF_FLOAT: {
+			switch (p_type) {
+				case Variant::FLOAT:
+					_put_half(double(p_value));
+					return;
+				case Variant::VECTOR2: {
+					const Vector2 v = p_value;
+					_put_half(v.x);
+					_put_half(v.y);
+				}
+					return;
+				case Variant::VECTOR3: {
+					const Vector3 v = p_value;
+					_put_half(v.x);
+					_put_half(v.y);
+					_put_half(v.z);
+				}
+					return;
+				case Variant::VECTOR4: {
+					const Vector4 v = p_value;
+					_put_half(v.x);
+					_put_half(v.y);
+					_put_half(v.z);
+					_put_half(v.w);
+				}
+					return;
+				case Variant::QUATERNION: {
+					const Quaternion q = p_value;
+					_put_half(q.x);
+					_put_half(q.y);
+					_put_half(q.z);
+					_put_half(q.w);
+				}
+					return;
+				case Variant::COLOR: {
+					const Color c = p_value;
+					_put_half(c.r);
+					_put_half(c.g);
+					_put_half(c.b);
+					_put_half(c.a);
+				}
+					return;
+				default:
+					break;
+			}
+		} break;
+		case EncodingProfile::SMALLEST_THREE: {
+			if (p_type != Variant::QUATERNION) {
+				break;
+			}
+			const Quaternion q = Quaternion(p_value).normalized();
+			const real_t components[4] = { q.x, q.y, q.z, q.w };
+			uint8_t largest = 0;
+			for (uint8_t i = 1; i < 4; i++) {
+				if (Math::abs(components[i]) > Math::abs(components[largest])) {
+					largest = i;
+				}
+			}
+			// q and -q are the same rotation, so the largest component is always sent as positive and omitted.
+			const double sign = components[largest] < 0 ? -1.0 : 1.0;
+			const uint8_t bits = p_profile.get_bits(10);
+			put_bits(largest, 2);
+			for (uint8_t i = 0; i < 4; i++) {
+				if (i != largest) {
+					put_bits(_quantize(components[i] * sign, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits), bits);
+				}
+			}
+		}
+			return;
+		case EncodingProfile::BITS: {
+			if (p_type == Variant::BOOL) {
+				put_bits(bool(p_value) ? 1 : 0, 1);
+				return;
+			}
+			if (p_type == Variant::INT) {
+				const uint8_t bits = p_profile.get_bits(8);
+				const int64_t offset = int64_t(p_value) - int64_t(p_profile.min);
+				put_bits(uint32_t(CLAMP(offset, int64_t(0), int64_t(_bit_mask(bits)))), bits);
+				return;
+			}
+		} break;
+		default:
+			break;
+	}
+
+	// The profile does not apply to this type.
+	put_value(p_value, p_type);
+}
+
+PackedByteArray StateWriter::finish() {
+	align();
+	buffer.resize(position);
+	PackedByteArray result = buffer;
+	buffer = PackedByteArray();
+	position = 0;
+	return result;
+}
+
+StateReader::StateReader(const PackedByteArray &p_buffer) :
+		buffer(p_buffer) {
+	data = buffer.ptr();
+	size = buffer.size();
+}
+
+const uint8_t *StateReader::_consume(int64_t p_bytes) {
+	if (unlikely(failed || p_bytes < 0 || position + p_bytes > size)) {
+		failed = true;
+		return nullptr;
+	}
+	const uint8_t *ptr = data + position;
+	position += p_bytes;
+	return ptr;
+}
+
+uint8_t StateReader::get_u8() {
+	const uint8_t *ptr = _consume(1);
+	return ptr ? *ptr : 0;
+}
+
+uint16_t StateReader::get_u16() {
+	const uint8_t *ptr = _consume(2);
+	return ptr ? uint16_t(ptr[0] | (ptr[1] << 8)) : 0;
+}
+
+uint32_t StateReader::get_u32() {
+	const uint8_t *ptr = _consume(4);
+	if (!ptr) {
+		return 0;
+	}
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++) {
+		value |= uint32_t(ptr[i]) << (i * 8);
+	}
+	return value;
+}
+
+uint64_t StateReader::get_u64() {
+	const uint8_t *ptr = _consume(8);
+	if (!ptr) {
+		return 0;
+	}
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++) {
+		value |= uint64_t(ptr[i]) << (i * 8);
+	}
+	return value;
+}
+
+float StateReader::get_float() {
+	const uint32_t bits = get_u32();
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+double StateReader::get_double() {
+	const uint64_t bits = get_u64();
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+real_t StateReader::get_real() {
+	if constexpr (sizeof(real_t) == sizeof(double)) {
+		return get_double();
+	} else {
+		return get_float();
+	}
+}
+
+uint64_t StateReader::get_varint() {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		const uint8_t *ptr = _consume(1);
+		if (!ptr) {
+			return 0;
+		}
+		value |= uint64_t(*ptr & 0x7F) << shift;
+		if (!(*ptr & 0x80)) {
+			return value;
+		}
+	}
+	failed = true;
+	return 0;
+}
+
+int64_t StateReader::get_zigzag() {
+	const uint64_t value = get_varint();
+	return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+String StateReader::get_string() {
+	const int64_t length = get_varint();
+	const uint8_t *ptr = _consume(length);
+	return ptr ? String::utf8((const char *)ptr, length) : String();
+}
+
+const uint8_t *StateReader::get_bytes(int64_t p_size) {
+	return _consume(p_size);
+}
+
+void StateReader::skip(int64_t p_bytes) {
+	_consume(p_bytes);
+}
+
+void StateReader::seek(int64_t p_position) {
+	ERR_FAIL_COND(p_position < 0 || p_position > size);
+	position = p_position;
+	failed = false;
+	align();
+}
+
+Variant StateReader::get_value(Variant::Type p_type) {
+	if (p_type == Variant::NIL) {
+		p_type = Variant::Type(get_u8());
+		if (unlikely(p_type >= Variant::VARIANT_MAX)) {
+			failed = true;
+			return Variant();
+		}
+	}
+
+	switch (p_type) {
+		case Variant::NIL:
+			return Variant();
+		case Variant::BOOL:
+			return get_u8() != 0;
+		case Variant::INT:
+			return get_zigzag();
+		case Variant::FLOAT:
+			return get_double();
+		case Variant::STRING:
+			return get_string();
+		case Variant::STRING_NAME:
+			return StringName(get_string());
+		case Variant::NODE_PATH:
+			return NodePath(get_string());
+		case Variant::VECTOR2: {
+			Vector2 v;
+			v.x = get_real();
+			v.y = get_real();
+			return v;
+		}
+		case Variant::VECTOR2I: {
+			Vector2i v;
+			v.x = get_zigzag();
+			v.y = get_zigzag();
+			return v;
+		}
+		case Variant::RECT2: {
+			Rect2 r;
+			r.position.x = get_real();
+			r.position.y = get_real();
+			r.size.x = get_real();
+			r.size.y = get_real();
+			return r;
+		}
+		case Variant::RECT2I: {
+			Rect2i r;
+			r.position.x = get_zigzag();
+			r.position.y = get_zigzag();
+			r.size.x = get_zigzag();
+			r.size.y = get_zigzag();
+			return r;
+		}
+		case Variant::VECTOR3: {
+			Vector3 v;
+			v.x = get_real();
+			v.y = get_real();
+			v.z = get_real();
+			return v;
+		}
+		case Variant::VECTOR3I: {
+			Vector3i v;
+			v.x = get_zigzag();
+			v.y = get_zigzag();
+			v.z = get_zigzag();
+			return v;
+		}
+		case Variant::TRANSFORM2D: {
+			Transform2D t;
+			for (int i = 0; i < 3; i++) {
+				t.columns[i].x = get_real();
+				t.columns[i].y = get_real();
+			}
+			return t;
+		}
+		case Variant::VECTOR4: {
+			Vector4 v;
+			v.x = get_real();
+			v.y = get_real();
+			v.z = get_real();
+			v.w = get_real();
+			return v;
+		}
+		case Variant::VECTOR4I: {
+			Vector4i v;
+			v.x = get_zigzag();
+			v.y = get_zigzag();
+			v.z = get_zigzag();
+			v.w = get_zigzag();
+			return v;
+		}
+		case Variant::PLANE: {
+			Plane p;
+			p.normal.x = get_real();
+			p.normal.y = get_real();
+			p.normal.z = get_real();
+			p.d = get_real();
+			return p;
+		}
+		case Variant::QUATERNION: {
+			Quaternion q;
+			q.x = get_real();
+			q.y = get_real();
+			q.z = get_real();
+			q.w = get_real();
+			return q;
+		}
+		case Variant::AABB: {
+			AABB a;
+			a.position.x = get_real();
+			a.position.y = get_real();
+			a.position.z = get_real();
+			a.size.x = get_real();
+			a.size.y = get_real();
+			a.size.z = get_real();
+			return a;
+		}
+		case Variant::BASIS: {
+			Basis b;
+			for (int i = 0; i < 3; i++) {
+				b.rows[i].x = get_real();
+				b.rows[i].y = get_real();
+				b.rows[i].z = get_real();
+			}
+			return b;
+		}
+		case Variant::TRANSFORM3D: {
+			Transform3D t;
+			for (int i = 0; i < 3; i++) {
+				t.basis.rows[i].x = get_real();
+				t.basis.rows[i].y = get_real();
+				t.basis.rows[i].z = get_real();
+			}
+			t.origin.x = get_real();
+			t.origin.y = get_real();
+			t.origin.z = get_real();
+			return t;
+		}
+		case Variant::COLOR: {
+			Color c;
+			c.r = get_float();
+			c.g = get_float();
+			c.b = get_float();
+			c.a = get_float();
+			return c;
+		}
+		default: {
+			const int64_t length = get_varint();
+			const uint8_t *ptr = _consume(length);
+			if (!ptr) {
+				return Variant();
+			}
+			PackedByteArray bytes;
+			bytes.resize(length);
+			memcpy(bytes.ptrw(), ptr, length);
+			return UtilityFunctions::bytes_to_var(bytes);
+		}
+	}
+}
+
+uint32_t StateReader::get_bits(uint8_t p_bits) {
+	uint32_t value = 0;
+	uint8_t read = 0;
+	while (read < p_bits) {
+		if (bit_count == 8) {
+			bit_ptr = _consume(1);
+			if (!bit_ptr) {
+				return 0;
+			}
+			bit_count = 0;
+		}
+		const uint8_t take = MIN(uint8_t(8 - bit_count), uint8_t(p_bits - read));
+		value |= uint32_t((*bit_ptr >> bit_count) & _bit_mask(take)) << read;
+		bit_count += take;
+		read += take;
+	}
+	return value;
+}
+
+double StateReader::_get_fixed(const EncodingProfile &p_profile) {
+	const uint8_t bits = p_profile.get_bits(16);
+	return _dequantize(get_bits(bits), p_profile.min, p_profile.max, bits);
+}
+
+float StateReader::_get_half() {
+	return _half_to_float(get_u16());
+}
+
+Variant StateReader::get_encoded(Variant::Type p_type, const EncodingProfile &p_profile) {
+	if (p_profile.mode == EncodingProfile::DEFAULT) {
+		return get_value(p_type);
+	}
+	if (p_type == Variant::NIL) {
+		p_type = Variant::Type(get_u8());
+		if (unlikely(p_type >= Variant::VARIANT_MAX)) {
+			failed = true;
+			return Variant();
+		}
+	}
+
+	switch (p_profile.mode) {
+		case EncodingProfile::FIXED_POINT: {
+			switch (p_type) {
+				case Variant::FLOAT:
+					return _get_fixed(p_profile);
+				case Variant::VECTOR2: {
+					Vector2 v;
+					v.x = _get_fixed(p_profile);
+					v.y = _get_fixed(p_profile);
+					return v;
+				}
+				case Variant::VECTOR3: {
+					Vector3 v;
+					v.x = _get_fixed(p_profile);
+					v.y = _get_fixed(p_profile);
+					v.z = _get_fixed(p_profile);
+					return v;
+				}
+				case Variant::VECTOR4: {
+					Vector4 v;
+					v.x = _get_fixed(p_profile);
+					v.y = _get_fixed(p_profile);
+					v.z = _get_fixed(p_profile);
+					v.w = _get_fixed(p_profile);
+					return v;
+				}
+				case Variant::COLOR: {
+					Color c;
+					c.r = _get_fixed(p_profile);
+					c.g = _get_fixed(p_profile);
+					c.b = _get_fixed(p_profile);
+					c.a = _get_fixed(p_profile);
+					return c;
+				}
+				default:
+					break;
+			}
+		} break;
+		case EncodingProfile::HALF_FLOAT: {
+			switch (p_type) {
+				case Variant::FLOAT:
+					return _get_half();
+				case Variant::VECTOR2: {
+					Vector2 v;
+					v.x = _get_half();
+					v.y = _get_half();
+					return v;
+				}
+				case Variant::VECTOR3: {
+					Vector3 v;
+					v.x = _get_half();
+					v.y = _get_half();
+					v.z = _get_half();
+					return v;
+				}
+				case Variant::VECTOR4: {
+					Vector4 v;
+					v.x = _get_half();
+					v.y = _get_half();
+					v.z = _get_half();
+					v.w = _get_half();
+					return v;
+				}
+				case Variant::QUATERNION: {
+					Quaternion q;
+					q.x = _get_half();
+					q.y = _get_half();
+					q.z = _get_half();
+					q.w = _get_half();
+					return q;
+				}
+				case Variant::COLOR: {
+					Color c;
+					c.r = _get_half();
+					c.g = _get_half();
+					c.b = _get_half();
+					c.a = _get_half();
+					return c;
+				}
+				default:
+					break;
+			}
+		} break;
+		case EncodingProfile::SMALLEST_THREE: {
+			if (p_type != Variant::QUATERNION) {
+				break;
+			}
+			const uint8_t bits = p_profile.get_bits(10);
+			const uint8_t largest = get_bits(2);
+			real_t components[4];
+			double sum = 0.0;
+			for (uint8_t i = 0; i < 4; i++) {
+				if (i != largest) {
+					components[i] = _dequantize(get_bits(bits), -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits);
+					sum += components[i] * components[i];
+				}
+			}
+			components[largest] = Math::sqrt(MAX(0.0, 1.0 - sum));
+			return Quaternion(components[0], components[1], components[2], components[3]);
+		}
+		case EncodingProfile::BITS: {
+			if (p_type == Variant::BOOL) {
+				return get_bits(1) != 0;
+			}
+			if (p_type == Variant::INT) {
+				return int64_t(get_bits(p_profile.get_bits(8))) + int64_t(p_profile.min);
+			}
+		} break;
+		default:
+			break;
+	}
+
+	return get_value(p_type);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+namespace godot {
+
+// Optional lossy encoding for a single replicated property. Modes that do not apply to a value's type fall back to the
+// default encoding.
+struct EncodingProfile {
+	enum Mode : uint8_t {
+		DEFAULT,
+		// Each real component clamped to [min, max] and quantized to `bits` bits (default 16).
+		FIXED_POINT,
+		// Each real component as an IEEE half float.
+		HALF_FLOAT,
+		// Quaternion as the index of its largest component plus the other three at `bits` bits each (default 10).
+		SMALLEST_THREE,
+		// Bools as a single bit, ints as `bits` bits (default 8) offset by min.
+		BITS,
+	};
+
+	Mode mode = DEFAULT;
+	uint8_t bits = 0;
+	double min = 0.0;
+	double max = 1.0;
+
+	uint8_t get_bits(uint8_t p_default) const { return bits > 0 ? MIN(bits, uint8_t(32)) : p_default; }
+};
+
+// Compact, schema-driven encoding of replicated values. When the replication plan knows a property's type the value is
+// written without a type header: ints as zigzag varints, reals and vectors as raw real_t components, strings as
+// length-prefixed UTF-8. Values of unknown (Variant::NIL) type are prefixed with a one byte type tag, and anything
+// without a compact form falls back to a length-prefixed var_to_bytes blob.
+class StateWriter {
+private:
+	PackedByteArray buffer;
+	int64_t position = 0;
+	// Bit-packed values share bytes reserved in the stream as they are needed, so they can interleave with byte values.
+	int64_t bit_byte = 0;
+	uint8_t bit_count = 8;
+
+	uint8_t *_reserve(int64_t p_bytes);
+	void _put_fixed(double p_value, const EncodingProfile &p_profile);
+	void _put_half(float p_value);
+
+public:
+	void put_u8(uint8_t p_value);
+	void put_u16(uint16_t p_value);
+	void put_u32(uint32_t p_value);
+	void put_u64(uint64_t p_value);
+	void put_float(float p_value);
+	void put_double(double p_value);
+	void put_real(real_t p_value);
+	void put_varint(uint64_t p_value);
+	void put_zigzag(int64_t p_value);
+	void put_bytes(const uint8_t *p_data, int64_t p_size);
+	void put_string(const String &p_value);
+	void put_bits(uint32_t p_value, uint8_t p_bits);
+	void put_value(const Variant &p_value, Variant::Type p_type);
+	void put_encoded(const Variant &p_value, Variant::Type p_type, const EncodingProfile &p_profile);
+	void align() { bit_count = 8; }
+	// Overwrites a u32 written earlier at p_position, e.g. a count that is only known once its entries are written.
+	void patch_u32(int64_t p_position, uint32_t p_value);
+
+	int64_t get_position() const { return position; }
+	const uint8_t *get_data() const { return buffer.ptr(); }
+	// Drops everything written after p_position.
+	void truncate(int64_t p_position) {
+		position = MIN(position, p_position);
+		align();
+	}
+	void clear() {
+		position = 0;
+		align();
+	}
+	PackedByteArray finish();
+};
+
+class StateReader {
+private:
+	PackedByteArray buffer;
+	const uint8_t *data = nullptr;
+	int64_t size = 0;
+	int64_t position = 0;
+	bool failed = false;
+	const uint8_t *bit_ptr = nullptr;
+	uint8_t bit_count = 8;
+
+	const uint8_t *_consume(int64_t p_bytes);
+	double _get_fixed(const EncodingProfile &p_profile);
+	float _get_half();
+
+public:
+	uint8_t get_u8();
+	uint16_t get_u16();
+	uint32_t get_u32();
+	uint64_t get_u64();
+	float get_float();
+	double get_double();
+	real_t get_real();
+	uint64_t get_varint();
+	int64_t get_zigzag();
+	String get_string();
+	const uint8_t *get_bytes(int64_t p_size);
+	uint32_t get_bits(uint8_t p_bits);
+	Variant get_value(Variant::Type p_type);
+	Variant get_encoded(Variant::Type p_type, const EncodingProfile &p_profile);
+	void skip(int64_t p_bytes);
+	// Moves to p_position and clears a failure, e.g. to resume at the next framed entry after a bad one.
+	void seek(int64_t p_position);
+	void align() { bit_count = 8; }
+
+	int64_t get_position() const { return position; }
+	const uint8_t *get_data() const { return data; }
+	int64_t get_available() const { return size - position; }
+	bool is_eof() const { return position >= size; }
+	bool has_failed() const { return failed; }
+
+	StateReader(const PackedByteArray &p_buffer);
+};
+
+} //namespace godot
@@ -0,0 +1,245 @@
+#include "state_history.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/quaternion.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector4.hpp>
+
+using namespace godot;
+
+uint8_t StateHistory::_get_width(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return 1;
+		case Variant::VECTOR2:
+			return 2;
+		case Variant::VECTOR3:
+			return 3;
+		case Variant::VECTOR4:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+void StateHistory::configure(const LocalVector<Variant::Type> &p_types, uint32_t p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 2, "State history must hold at least 2 frames.");
+	types = p_types;
+	offsets.resize(types.size());
+	widths.resize(types.size());
+	real_stride = 0;
+	variant_stride = 0;
+	for (uint32_t i = 0; i < types.size(); i++) {
+		widths[i] = _get_width(types[i]);
+		if (widths[i] > 0) {
+			offsets[i] = real_stride;
+			real_stride += widths[i];
+		} else {
+			offsets[i] = variant_stride++;
+		}
+	}
+
+	times.resize(p_capacity);
+	positions.resize(p_capacity);
+	reals.resize(p_capacity * real_stride);
+	variants.resize(p_capacity * variant_stride);
+	clear();
+}
+
+void StateHistory::reset() {
+	types.clear();
+	offsets.clear();
+	widths.clear();
+	real_stride = 0;
+	variant_stride = 0;
+	times.clear();
+	positions.clear();
+	reals.clear();
+	variants.clear();
+	head = 0;
+	count = 0;
+}
+
+void StateHistory::clear() {
+	for (Variant &value : variants) {
+		value = Variant();
+	}
+	head = 0;
+	count = 0;
+}
+
+uint32_t StateHistory::record(uint64_t p_usec, const Vector3 &p_position) {
+	const uint32_t capacity = times.size();
+	ERR_FAIL_COND_V_MSG(capacity == 0, 0, "State history is not configured.");
+	if (count > 0 && p_usec < times[_get_slot(count - 1)]) {
+		// Time went backwards, the recorded frames can no longer be searched.
+		clear();
+	}
+
+	const uint32_t slot = _get_slot(count == capacity ? 0 : count);
+	if (count == capacity) {
+		head = (head + 1) % capacity;
+	} else {
+		count++;
+	}
+	times[slot] = p_usec;
+	positions[slot] = p_position;
+	return slot;
+}
+
+void StateHistory::set_value(uint32_t p_slot, uint32_t p_field, const Variant &p_value) {
+	ERR_FAIL_UNSIGNED_INDEX(p_slot, times.size());
+	ERR_FAIL_UNSIGNED_INDEX(p_field, types.size());
+	if (widths[p_field] == 0) {
+		variants[p_slot * variant_stride + offsets[p_field]] = p_value;
+		return;
+	}
+
+	real_t *components = reals.ptr() + p_slot * real_stride + offsets[p_field];
+	if (p_value.get_type() != types[p_field]) {
+		// Missing targets sample as zero rather than leaving a stale value behind.
+		for (uint8_t c = 0; c < widths[p_field]; c++) {
+			components[c] = 0;
+		}
+		return;
+	}
+	switch (types[p_field]) {
+		case Variant::FLOAT: {
+			components[0] = real_t(double(p_value));
+		} break;
+		case Variant::VECTOR2: {
+			const Vector2 value = p_value;
+			components[0] = value.x;
+			components[1] = value.y;
+		} break;
+		case Variant::VECTOR3: {
+			const Vector3 value = p_value;
+			components[0] = value.x;
+			components[1] = value.y;
+			components[2] = value.z;
+		} break;
+		case Variant::VECTOR4: {
+			const Vector4 value = p_value;
+			components[0] = value.x;
+			components[1] = value.y;
+			components[2] = value.z;
+			components[3] = value.w;
+		} break;
+		case Variant::QUATERNION: {
+			const Quaternion value = p_value;
+			components[0] = value.x;
+			components[1] = value.y;
+			components[2] = value.z;
+			components[3] = value.w;
+		} break;
+		case Variant::COLOR: {
+			const Color value = p_value;
+			components[0] = value.r;
+			components[1] = value.g;
+			components[2] = value.b;
+			components[3] = value.a;
+		} break;
+		default:
+			break;
+	}
+}
+
+bool StateHistory::_find_frames(uint64_t p_usec, uint32_t &r_from, uint32_t &r_to, real_t &r_weight) const {
+	if (count == 0) {
+		return false;
+	}
+	r_weight = 0;
+	if (p_usec <= times[head]) {
+		r_from = r_to = head;
+		return true;
+	}
+	const uint32_t newest = _get_slot(count - 1);
+	if (p_usec >= times[newest]) {
+		r_from = r_to = newest;
+		return true;
+	}
+
+	// Last frame at or before p_usec; the checks above keep it below the newest frame.
+	uint32_t low = 0;
+	uint32_t high = count - 1;
+	while (high - low > 1) {
+		const uint32_t mid = low + (high - low) / 2;
+		if (times[_get_slot(mid)] <= p_usec) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+	r_from = _get_slot(low);
+	r_to = _get_slot(high);
+	const uint64_t span = times[r_to] - times[r_from];
+	r_weight = span > 0 ? real_t(double(p_usec - times[r_from]) / double(span)) : 0;
+	return true;
+}
+
+Variant StateHistory::_get_value(uint32_t p_field, uint32_t p_from, uint32_t p_to, real_t p_weight) const {
+	if (widths[p_field] == 0) {
+		// Discrete values hold until the next frame is reached.
+		return variants[p_from * variant_stride + offsets[p_field]];
+	}
+
+	const real_t *from = reals.ptr() + p_from * real_stride + offsets[p_field];
+	const real_t *to = reals.ptr() + p_to * real_stride + offsets[p_field];
+	real_t c[4];
+	if (types[p_field] == Variant::QUATERNION) {
+		// Normalized lerp along the shorter arc, close enough to slerp between adjacent frames.
+		const real_t dot = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+		const real_t sign = dot < 0 ? -1 : 1;
+		for (uint8_t i = 0; i < 4; i++) {
+			c[i] = Math::lerp(from[i], to[i] * sign, p_weight);
+		}
+		const Quaternion value(c[0], c[1], c[2], c[3]);
+		return value.length_squared() > 0 ? value.normalized() : Quaternion(from[0], from[1], from[2], from[3]);
+	}
+	for (uint8_t i = 0; i < widths[p_field]; i++) {
+		c[i] = Math::lerp(from[i], to[i], p_weight);
+	}
+	switch (types[p_field]) {
+		case Variant::FLOAT:
+			return c[0];
+		case Variant::VECTOR2:
+			return Vector2(c[0], c[1]);
+		case Variant::VECTOR3:
+			return Vector3(c[0], c[1], c[2]);
+		case Variant::VECTOR4:
+			return Vector4(c[0], c[1], c[2], c[3]);
+		case Variant::COLOR:
+			return Color(c[0], c[1], c[2], c[3]);
+		default:
+			return Variant();
+	}
+}
+
+bool StateHistory::sample(uint64_t p_usec, Array &r_values) const {
+	uint32_t from = 0;
+	uint32_t to = 0;
+	real_t weight = 0;
+	if (!_find_frames(p_usec, from, to, weight)) {
+		return false;
+	}
+	r_values.resize(types.size());
+	for (uint32_t i = 0; i < types.size(); i++) {
+		r_values[i] = _get_value(i, from, to, weight);
+	}
+	return true;
+}
+
+bool StateHistory::sample_position(uint64_t p_usec, Vector3 &r_position) const {
+	uint32_t from = 0;
+	uint32_t to = 0;
+	real_t weight = 0;
+	if (!_find_frames(p_usec, from, to, weight)) {
+		return false;
+	}
+	r_position = positions[from].lerp(positions[to], weight);
+	return true;
+}
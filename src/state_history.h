@@ -0,0 +1,57 @@
+#pragma once
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+namespace godot {
+
+// Fixed-size ring of sampled sync states for lag compensation. Interpolable fields (floats, vectors, quaternions and
+// colors) are flattened into a shared real_t buffer so recording does not allocate, everything else is kept as a
+// Variant per frame and is not interpolated. Every frame also stores the root node position for radius queries.
+class StateHistory {
+private:
+	LocalVector<Variant::Type> types;
+	// Offset of each field in its frame, into reals for interpolable fields and into variants otherwise.
+	LocalVector<uint32_t> offsets;
+	// real_t components of each field, 0 for fields stored as a Variant.
+	LocalVector<uint8_t> widths;
+	uint32_t real_stride = 0;
+	uint32_t variant_stride = 0;
+
+	LocalVector<uint64_t> times;
+	LocalVector<Vector3> positions;
+	LocalVector<real_t> reals;
+	LocalVector<Variant> variants;
+	uint32_t head = 0;
+	uint32_t count = 0;
+
+	static uint8_t _get_width(Variant::Type p_type);
+	uint32_t _get_slot(uint32_t p_frame) const { return (head + p_frame) % times.size(); }
+	bool _find_frames(uint64_t p_usec, uint32_t &r_from, uint32_t &r_to, real_t &r_weight) const;
+	Variant _get_value(uint32_t p_field, uint32_t p_from, uint32_t p_to, real_t p_weight) const;
+
+public:
+	void configure(const LocalVector<Variant::Type> &p_types, uint32_t p_capacity);
+	bool is_configured() const { return !times.is_empty(); }
+	void reset();
+	void clear();
+
+	// Starts a new frame, overwriting the oldest one once the ring is full, and returns its slot.
+	uint32_t record(uint64_t p_usec, const Vector3 &p_position);
+	void set_value(uint32_t p_slot, uint32_t p_field, const Variant &p_value);
+
+	// Samples the state at p_usec, interpolating between the two frames around it. Times outside the recorded range
+	// clamp to the oldest or newest frame.
+	bool sample(uint64_t p_usec, Array &r_values) const;
+	bool sample_position(uint64_t p_usec, Vector3 &r_position) const;
+
+	uint32_t get_count() const { return count; }
+	uint32_t get_field_count() const { return types.size(); }
+	uint64_t get_oldest_usec() const { return count > 0 ? times[head] : 0; }
+	uint64_t get_newest_usec() const { return count > 0 ? times[_get_slot(count - 1)] : 0; }
+};
+
+} //namespace godot
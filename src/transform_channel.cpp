@@ -0,0 +1,247 @@
+#include "transform_channel.h"
+
+#include "scene_synchronizer.h"
+
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+
+using namespace godot;
+
+static constexpr float ROTATION_SCALE = 32767.0f;
+// Largest float below 2^31, so clamped positions always fit in an int32.
+static constexpr float QUANTIZED_LIMIT = 2147483520.0f;
+
+void TransformChannel::add_slot() {
+	for (int c = 0; c < COMPONENT_MAX; c++) {
+		values[c].push_back(0.0f);
+		quantized[c].push_back(0);
+		sent[c].push_back(0);
+	}
+	active.push_back(0);
+	has_sent.push_back(0);
+	changed.push_back(0);
+}
+
+void TransformChannel::remove_slot(uint32_t p_index) {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, active.size());
+	const uint32_t last = active.size() - 1;
+	if (p_index != last) {
+		for (int c = 0; c < COMPONENT_MAX; c++) {
+			sent[c][p_index] = sent[c][last];
+		}
+		has_sent[p_index] = has_sent[last];
+	}
+	for (int c = 0; c < COMPONENT_MAX; c++) {
+		values[c].resize(last);
+		quantized[c].resize(last);
+		sent[c].resize(last);
+	}
+	active.resize(last);
+	has_sent.resize(last);
+	changed.resize(last);
+}
+
+void TransformChannel::reset_baseline() {
+	for (uint8_t &flag : has_sent) {
+		flag = 0;
+	}
+}
+
+void TransformChannel::set_position_step(float p_step) {
+	ERR_FAIL_COND_MSG(p_step <= 0.0f, "Position step must be greater than 0.");
+	position_step = p_step;
+	reset_baseline();
+}
+
+void TransformChannel::_gather(const LocalVector<SceneSynchronizer *> &p_synchronizers) {
+	float *px = values[POSITION_X].ptr();
+	float *py = values[POSITION_Y].ptr();
+	float *pz = values[POSITION_Z].ptr();
+	float *rx = values[ROTATION_X].ptr();
+	float *ry = values[ROTATION_Y].ptr();
+	float *rz = values[ROTATION_Z].ptr();
+	float *rw = values[ROTATION_W].ptr();
+
+	for (uint32_t i = 0; i < p_synchronizers.size(); i++) {
+		active[i] = 0;
+		SceneSynchronizer *synchronizer = p_synchronizers[i];
+		if (!synchronizer->transform_channel_enabled || synchronizer->net_id == 0) {
+			// Without a net ID the entry can't be addressed. Force a full send once the channel is usable again.
+			has_sent[i] = 0;
+			continue;
+		}
+		Node *root = synchronizer->get_root_node();
+		Quaternion rotation;
+		if (const Node3D *node_3d = Object::cast_to<Node3D>(root)) {
+			const Vector3 position = node_3d->get_position();
+			px[i] = position.x;
+			py[i] = position.y;
+			pz[i] = position.z;
+			rotation = node_3d->get_quaternion();
+		} else if (const Node2D *node_2d = Object::cast_to<Node2D>(root)) {
+			const Vector2 position = node_2d->get_position();
+			px[i] = position.x;
+			py[i] = position.y;
+			pz[i] = 0.0f;
+			rotation = Quaternion(Vector3(0, 0, 1), node_2d->get_rotation());
+		} else {
+			continue;
+		}
+		// q and -q are the same rotation; keep w positive so unchanged rotations quantize identically.
+		if (rotation.w < 0) {
+			rotation = -rotation;
+		}
+		rx[i] = rotation.x;
+		ry[i] = rotation.y;
+		rz[i] = rotation.z;
+		rw[i] = rotation.w;
+		active[i] = 1;
+	}
+}
+
+void TransformChannel::_quantize() {
+	const uint32_t count = active.size();
+	const float inv_step = 1.0f / position_step;
+
+	for (int c = 0; c < COMPONENT_MAX; c++) {
+		const float scale = c < ROTATION_X ? inv_step : ROTATION_SCALE;
+		const float *src = values[c].ptr();
+		int32_t *dst = quantized[c].ptr();
+		for (uint32_t i = 0; i < count; i++) {
+			float v = src[i] * scale;
+			v = v < -QUANTIZED_LIMIT ? -QUANTIZED_LIMIT : (v > QUANTIZED_LIMIT ? QUANTIZED_LIMIT : v);
+			dst[i] = int32_t(v + (v >= 0.0f ? 0.5f : -0.5f));
+		}
+	}
+}
+
+uint32_t TransformChannel::_diff() {
+	const uint32_t count = active.size();
+	const int32_t *q[COMPONENT_MAX];
+	const int32_t *s[COMPONENT_MAX];
+	for (int c = 0; c < COMPONENT_MAX; c++) {
+		q[c] = quantized[c].ptr();
+		s[c] = sent[c].ptr();
+	}
+	const uint8_t *act = active.ptr();
+	const uint8_t *prev = has_sent.ptr();
+	uint8_t *out = changed.ptr();
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint8_t mask = 0;
+		mask |= (q[POSITION_X][i] != s[POSITION_X][i]) ? CHANGED_POSITION_X : 0;
+		mask |= (q[POSITION_Y][i] != s[POSITION_Y][i]) ? CHANGED_POSITION_Y : 0;
+		mask |= (q[POSITION_Z][i] != s[POSITION_Z][i]) ? CHANGED_POSITION_Z : 0;
+		mask |= ((q[ROTATION_X][i] != s[ROTATION_X][i]) | (q[ROTATION_Y][i] != s[ROTATION_Y][i]) |
+						(q[ROTATION_Z][i] != s[ROTATION_Z][i]) | (q[ROTATION_W][i] != s[ROTATION_W][i]))
+				? CHANGED_ROTATION
+				: 0;
+		mask = prev[i] ? mask : uint8_t(CHANGED_ALL);
+		out[i] = act[i] ? mask : 0;
+	}
+
+	if (refresh_interval > 0) {
+		// Full refresh of every refresh_interval-th slot, rotating so each slot comes up once per interval.
+		for (uint32_t i = write_count % refresh_interval; i < count; i += refresh_interval) {
+			out[i] = act[i] ? uint8_t(CHANGED_ALL) : 0;
+		}
+	}
+
+	uint32_t changed_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		changed_count += out[i] != 0;
+	}
+	return changed_count;
+}
+
+uint32_t TransformChannel::write(const LocalVector<SceneSynchronizer *> &p_synchronizers, StateWriter &r_writer) {
+	ERR_FAIL_COND_V(p_synchronizers.size() != active.size(), 0);
+	_gather(p_synchronizers);
+	_quantize();
+	const uint32_t changed_count = _diff();
+	write_count++;
+	if (changed_count == 0) {
+		return 0;
+	}
+
+	uint32_t written = 0;
+	r_writer.put_float(position_step);
+	for (uint32_t i = 0; i < active.size(); i++) {
+		const uint8_t mask = changed[i];
+		if (mask == 0) {
+			continue;
+		}
+		r_writer.put_varint(p_synchronizers[i]->net_id);
+		r_writer.put_u8(mask);
+		for (int c = POSITION_X; c <= POSITION_Z; c++) {
+			if (mask & (1 << c)) {
+				r_writer.put_zigzag(quantized[c][i]);
+				sent[c][i] = quantized[c][i];
+			}
+		}
+		if (mask & CHANGED_ROTATION) {
+			for (int c = ROTATION_X; c <= ROTATION_W; c++) {
+				r_writer.put_zigzag(quantized[c][i]);
+				sent[c][i] = quantized[c][i];
+			}
+		}
+		has_sent[i] = 1;
+		written++;
+	}
+	return written;
+}
+
+Error TransformChannel::skip_entry(StateReader &p_reader) {
+	const uint8_t mask = p_reader.get_u8();
+	ERR_FAIL_COND_V(p_reader.has_failed() || (mask & ~CHANGED_ALL), ERR_INVALID_DATA);
+	const int count = ((mask & CHANGED_POSITION_X) ? 1 : 0) + ((mask & CHANGED_POSITION_Y) ? 1 : 0) + ((mask & CHANGED_POSITION_Z) ? 1 : 0) + ((mask & CHANGED_ROTATION) ? 4 : 0);
+	for (int i = 0; i < count; i++) {
+		p_reader.get_varint();
+	}
+	return p_reader.has_failed() ? ERR_INVALID_DATA : OK;
+}
+
+Error TransformChannel::read_entry(StateReader &p_reader, float p_position_step, SceneSynchronizer *p_synchronizer) {
+	ERR_FAIL_NULL_V(p_synchronizer, FAILED);
+	const uint8_t mask = p_reader.get_u8();
+	ERR_FAIL_COND_V(p_reader.has_failed() || (mask & ~CHANGED_ALL), ERR_INVALID_DATA);
+
+	double position[3] = {};
+	for (int c = POSITION_X; c <= POSITION_Z; c++) {
+		if (mask & (1 << c)) {
+			position[c] = double(p_reader.get_zigzag()) * p_position_step;
+		}
+	}
+	Quaternion rotation;
+	if (mask & CHANGED_ROTATION) {
+		rotation.x = p_reader.get_zigzag() / ROTATION_SCALE;
+		rotation.y = p_reader.get_zigzag() / ROTATION_SCALE;
+		rotation.z = p_reader.get_zigzag() / ROTATION_SCALE;
+		rotation.w = p_reader.get_zigzag() / ROTATION_SCALE;
+		rotation = rotation.length_squared() > 0 ? rotation.normalized() : Quaternion();
+	}
+	ERR_FAIL_COND_V(p_reader.has_failed(), ERR_INVALID_DATA);
+
+	Node *root = p_synchronizer->get_root_node();
+	if (Node3D *node_3d = Object::cast_to<Node3D>(root)) {
+		Vector3 current = node_3d->get_position();
+		current.x = (mask & CHANGED_POSITION_X) ? position[POSITION_X] : current.x;
+		current.y = (mask & CHANGED_POSITION_Y) ? position[POSITION_Y] : current.y;
+		current.z = (mask & CHANGED_POSITION_Z) ? position[POSITION_Z] : current.z;
+		node_3d->set_position(current);
+		if (mask & CHANGED_ROTATION) {
+			node_3d->set_quaternion(rotation);
+		}
+	} else if (Node2D *node_2d = Object::cast_to<Node2D>(root)) {
+		Vector2 current = node_2d->get_position();
+		current.x = (mask & CHANGED_POSITION_X) ? position[POSITION_X] : current.x;
+		current.y = (mask & CHANGED_POSITION_Y) ? position[POSITION_Y] : current.y;
+		node_2d->set_position(current);
+		if (mask & CHANGED_ROTATION) {
+			node_2d->set_rotation(2.0 * Math::atan2(rotation.z, rotation.w));
+		}
+	} else {
+		ERR_FAIL_V_MSG(ERR_UNCONFIGURED, "Transform channel requires a Node2D or Node3D root node.");
+	}
+	return OK;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "state_codec.h"
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+namespace godot {
+
+class SceneSynchronizer;
+
+// Bulk replication of synchronizer root node transforms (Node2D or Node3D position and rotation). Values are gathered
+// into structure-of-arrays buffers and then quantized, compared against the last sent snapshot and packed in flat
+// loops over plain arrays, which the compiler can vectorize. Slots mirror SceneSynchronizerServer's arrays.
+//
+// Packets start with the position step as a float, followed by entries of varint net_id, a u8 change mask and a zigzag
+// varint per changed component. 2D rotations travel as a quaternion around the Z axis.
+//
+// The last sent snapshot is shared by every receiver and never acknowledged, so packets must be delivered reliable and
+// ordered for receivers to stay in step. As a backstop every slot is also sent in full once per refresh_interval
+// writes, a slice of the slots at a time, which lets receivers that missed a packet or joined late converge.
+class TransformChannel {
+public:
+	enum Component {
+		POSITION_X,
+		POSITION_Y,
+		POSITION_Z,
+		ROTATION_X,
+		ROTATION_Y,
+		ROTATION_Z,
+		ROTATION_W,
+		COMPONENT_MAX,
+	};
+
+	enum ChangeFlags : uint8_t {
+		CHANGED_POSITION_X = 1 << 0,
+		CHANGED_POSITION_Y = 1 << 1,
+		CHANGED_POSITION_Z = 1 << 2,
+		CHANGED_ROTATION = 1 << 3,
+		CHANGED_ALL = 0x0F,
+	};
+
+private:
+	LocalVector<float> values[COMPONENT_MAX];
+	LocalVector<int32_t> quantized[COMPONENT_MAX];
+	LocalVector<int32_t> sent[COMPONENT_MAX];
+	LocalVector<uint8_t> active;
+	LocalVector<uint8_t> has_sent;
+	LocalVector<uint8_t> changed;
+	float position_step = 0.001f;
+	uint32_t refresh_interval = 60;
+	uint32_t write_count = 0;
+
+	void _gather(const LocalVector<SceneSynchronizer *> &p_synchronizers);
+	void _quantize();
+	uint32_t _diff();
+
+public:
+	void add_slot();
+	void remove_slot(uint32_t p_index);
+	void reset_baseline();
+
+	void set_position_step(float p_step);
+	float get_position_step() const { return position_step; }
+	// Number of writes over which every slot is sent in full once, 0 to only send changes.
+	void set_refresh_interval(uint32_t p_interval) { refresh_interval = p_interval; }
+	uint32_t get_refresh_interval() const { return refresh_interval; }
+
+	// Gathers, quantizes and diffs every slot, then writes the changed ones. Returns the number of entries written.
+	uint32_t write(const LocalVector<SceneSynchronizer *> &p_synchronizers, StateWriter &r_writer);
+	// Applies a single entry to a synchronizer's root node. The packet header must already have been read.
+	static Error read_entry(StateReader &p_reader, float p_position_step, SceneSynchronizer *p_synchronizer);
+	static Error skip_entry(StateReader &p_reader);
+};
+
+} //namespace godot